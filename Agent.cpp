@@ -1,76 +1,108 @@
 #include "Agent.h"
+#include "Coyote.h"
+#include "Roadrunner.h"
+#include "Hashing.h"
 
-Agent::Agent(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, BoardOccupantTypes type) {
+Agent::Agent(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, BoardOccupantTypes type, bool addToBoard) {
 	this->breedCountdown = breedCountdown;
 	this->location = location;
 	alive = true;
 	this->board = board;
-	this->board->addAgent(type, location);
+	this->type = type;
+	randomStream = NULL;
+	if (addToBoard) {
+		this->board->addAgent(type, location);
+	}
+}
+
+Agent::~Agent() {
+
 }
 
 bool Agent::isAlive() {
 	return alive;
 }
 
+Coordinates Agent::getLocation() {
+	return location;
+}
+
+BoardOccupantTypes Agent::getType() {
+	return type;
+}
+
+AgentState Agent::getState() {
+	AgentState state;
+	state.type = type;
+	state.row = location.getRow();
+	state.column = location.getColumn();
+	state.breedCountdown = breedCountdown;
+	state.timeSinceLastMeal = 0;
+	return state;
+}
+
+Agent* Agent::fromState(SimulationBoard* board, AgentState state) {
+	Coordinates stateLocation(state.row, state.column);
+	if (state.type == BoardOccupantTypes::coyote) {
+		return new Coyote(board, stateLocation, state.breedCountdown, state.timeSinceLastMeal);
+	}
+	return new Roadrunner(board, stateLocation, state.breedCountdown);
+}
+
 void Agent::die() {
 	alive = false;
 }
-Coordinates Agent::findRandomViableLocation(Coordinates currentPosition, BoardOccupantTypes criteria) {
-	Coordinates foundLocation;
-	std::vector<char> locationToBreed = { 'u', 'd', 'l', 'r' };
-	int index;
-
-	//In this loop, a random location is determined (up, down, left, or right). If the randomly selected location does not fulfill
-	//the criteria, the location is removed from the locationToBreed vector and the process is repeated with the remaining locations in the
-	//vector
-	while (locationToBreed.size() > 0) {
+const signed char Agent::directionTable[16][Agent::numOfDirectionDraws] = {
+	{ -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 },
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+	{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+	{ 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1 },
+	{ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+	{ 0, 2, 0, 2, 0, 2, 0, 2, 0, 2, 0, 2 },
+	{ 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2 },
+	{ 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2 },
+	{ 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 },
+	{ 0, 3, 0, 3, 0, 3, 0, 3, 0, 3, 0, 3 },
+	{ 1, 3, 1, 3, 1, 3, 1, 3, 1, 3, 1, 3 },
+	{ 0, 1, 3, 0, 1, 3, 0, 1, 3, 0, 1, 3 },
+	{ 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3 },
+	{ 0, 2, 3, 0, 2, 3, 0, 2, 3, 0, 2, 3 },
+	{ 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3 },
+	{ 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3 }
+};
 
-		//choosing a random location from the vector
-		index = rand() % locationToBreed.size();
+int Agent::randomNumber() {
+	if (randomStream == NULL) {
+		return rand();
+	}
+	//a counter-based stream: every draw scrambles the next value of the counter, so the stream needs no other state
+	return (int)(mixBits((*randomStream)++) % ((unsigned long long)RAND_MAX + 1));
+}
 
-		switch (locationToBreed[index]) { //randomly selected location is checked to see if it satisfies criteria
-		case 'u':
-			foundLocation.setCoordinates(currentPosition.getRow() - 1, currentPosition.getColumn()); //this is the randomly selected location
-			if (board->existsHere(criteria, foundLocation)) { //check to see if the location meets the criteria and is within the bounds of the board
-				return foundLocation; //if location satisfies the criteria, it is returned
-			}
-			else {
-				//if the above check fails, the location is erased from the available options and the process is repeated
-				//with the other locations
-				locationToBreed.erase(locationToBreed.begin() + index);
-			}
-			break;
-			//Rest of the cases follow the same formula
-		case 'd':
-			foundLocation.setCoordinates(currentPosition.getRow() + 1, currentPosition.getColumn());
-			if (board->existsHere(criteria, foundLocation)) {
-				return foundLocation;
-			}
-			else {
-				locationToBreed.erase(locationToBreed.begin() + index);
-			}
-			break;
-		case 'l':
-			foundLocation.setCoordinates(currentPosition.getRow(), currentPosition.getColumn() - 1);
-			if (board->existsHere(criteria, foundLocation)) {
-				return foundLocation;
-			}
-			else {
-				locationToBreed.erase(locationToBreed.begin() + index);
-			}
-			break;
-		case 'r':
-			foundLocation.setCoordinates(currentPosition.getRow(), currentPosition.getColumn() + 1);
-			if (board->existsHere(criteria, foundLocation)) {
-				return foundLocation;
-			}
-			else {
-				locationToBreed.erase(locationToBreed.begin() + index);
-			}
-			break;
-		}
+int Agent::randomDirection(unsigned long long mask) {
+	if (mask < 16) {
+		return directionTable[mask][randomNumber() % numOfDirectionDraws];
+	}
+	//drop a random number of the lowest set bits, then take the lowest one left
+	int skip = randomNumber() % __builtin_popcountll(mask);
+	for (int i = 0; i < skip; i++) {
+		mask &= mask - 1;
 	}
+	return __builtin_ctzll(mask);
+}
+
+Coordinates Agent::stepInDirection(Coordinates currentPosition, int direction) {
+	const Neighborhood &neighborhood = board->getNeighborhood();
+	return Coordinates(currentPosition.getRow() + neighborhood.getRowOffset(direction), currentPosition.getColumn() + neighborhood.getColumnOffset(direction));
+}
 
-	foundLocation.setToNULL(); //if no location meets the criteria, an uninitialized location is returned
-	return foundLocation;
+Coordinates Agent::findRandomViableLocation(Coordinates currentPosition, BoardOccupantTypes criteria) {
+	Coordinates foundLocation;
+	//all viable adjacent locations are found at once, and one of them is picked with a single random draw
+	unsigned long long viableDirections = board->neighborMask(currentPosition, criteria, type);
+	if (viableDirections == 0) {
+		foundLocation.setToNULL(); //if no location meets the criteria, an uninitialized location is returned
+		return foundLocation;
+	}
+	return stepInDirection(currentPosition, randomDirection(viableDirections));
 }
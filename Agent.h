@@ -8,12 +8,79 @@
 #include <time.h>
 
 
+/**
+	A plain copy of the state of an agent. Used to send an agent to another process or to write it to a file and to recreate it there
+*/
+struct AgentState {
+	///The type of the agent (coyote or roadrunner)
+	BoardOccupantTypes type;
+	///The row in which the agent resides
+	unsigned int row;
+	///The column in which the agent resides
+	unsigned int column;
+	///The number of turns left until the agent breeds
+	unsigned int breedCountdown;
+	///The number of turns since the agent last ate. Always 0 for roadrunners
+	unsigned int timeSinceLastMeal;
+};
+
+/**
+	The move and the birth that an agent intends to make during a synchronous time step. Intents are computed against the read-only
+	previous-step board and are then granted or denied by the SynchronousUpdater when it resolves conflicts between agents.
+*/
+struct AgentIntent {
+	///The location the agent wants to move to. Uninitialized (or equal to the agent's location) if the agent wants to stay put
+	Coordinates moveTo;
+	///The location in which the agent wants to give birth. Uninitialized if the agent will not breed this step
+	Coordinates birthAt;
+	///True if moveTo is occupied by a roadrunner that the agent (a coyote) wants to eat
+	bool eats = false;
+	///Random priority used to resolve conflicts. Higher priority wins
+	unsigned int priority = 0;
+	///The state of the random stream the agent draws from while planning. Seeded by the SynchronousUpdater, so that every agent has a
+	///stream of its own and the plans do not depend on the order they are computed in
+	unsigned long long randomState = 0;
+	///Set by the conflict resolution: true if the agent is allowed to move to moveTo
+	bool moveGranted = false;
+	///Set by the conflict resolution: true if the agent is allowed to give birth at birthAt
+	bool birthGranted = false;
+	///Set by the conflict resolution: true if the agent (a roadrunner) was eaten by a coyote this step
+	bool eaten = false;
+};
+
 /**
 An abstract class representing an entity at play in the simulation. It is the base class of the Coyote and Roadrunner classes.
 */
 class Agent {
 protected:
-	/**Implementation function that returns a random adjacent location out of all four adjacent locations (up, down, left, right) that satisfy the given criteria.
+	///The number of random draws that each row of directionTable is spread over. It is divisible by 1, 2, 3 and 4, so that every
+	///direction set in a mask is chosen by the same number of draws
+	static const unsigned int numOfDirectionDraws = 12;
+	///directionTable[mask][draw] is the direction (0 = up, 1 = down, 2 = left, 3 = right) chosen out of the directions set in a neighbor
+	///mask for a random draw between 0 and numOfDirectionDraws - 1. Every direction set in the mask is equally likely. -1 for an empty mask
+	static const signed char directionTable[16][numOfDirectionDraws];
+
+	/**Draws a random number from the random stream of the agent, or from rand() if it has none
+	\return A random number between 0 and RAND_MAX
+	*/
+	int randomNumber();
+
+	/**Chooses one of the directions set in a neighbor mask uniformly at random, using a single random draw. Masks of the four
+	adjacent locations are looked up in directionTable; larger masks pick the n-th set bit
+	\param mask A neighbor mask, as returned by SimulationBoard::neighborMask(). Must not be 0
+	\return The chosen direction: the index of a neighbor in the neighborhood of the board (0 = up, 1 = down, 2 = left, 3 = right, and
+	further neighbors after those)
+	*/
+	int randomDirection(unsigned long long mask);
+
+	/**Returns the neighbor of a location in a given direction
+	\param currentPosition The starting location
+	\param direction The index of the neighbor in the neighborhood of the board
+	\return The neighboring location. May be outside the board
+	*/
+	Coordinates stepInDirection(Coordinates currentPosition, int direction);
+
+	/**Implementation function that returns a random neighboring location out of all the neighbors in the neighborhood of the board (by default up, down, left, right) that satisfy the given criteria, as seen by the agent: the terrain keeps roadrunners out of water and hides roadrunners in cover from coyotes.
 	If no such location is found, then an uninitialized location is returned
 	\param currentPosition The position in relation to which the random adjacent location is to be calculated
 	\criteria The criteria that must be met by the randomly selected location-to-be-returned
@@ -28,6 +95,11 @@ protected:
 	Coordinates location;
 	///The board in which the object resides
 	SimulationBoard* board;
+	///The type of the object on the board (coyote or roadrunner)
+	BoardOccupantTypes type;
+	///The state of the random stream the object draws from while it plans a synchronous time step (the randomState of its intent), or
+	///NULL to draw from rand()
+	unsigned long long* randomStream;
 	/**
 	Pure virtual function to be overriden by child class.
 	It executes the breed mechanism of the object.
@@ -49,17 +121,55 @@ public:
 		\param location The location in which the objects of the classes that inherit from Agent will reside
 		\param breedCountdown The interval of time after which the objects of the classes that inherit from Agent will breed
 		\param type The type of the child class being instantiated (could be coyote or roadrunner)
+		\param addToBoard False if the caller writes the object into the board itself, as the synchronous update mode does for the babies
 	*/
-	Agent(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, BoardOccupantTypes type);
+	Agent(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, BoardOccupantTypes type, bool addToBoard = true);
+
+	/**Virtual so that the coyotes and roadrunners can be deleted through Agent pointers, as the agent lists hold them
+	*/
+	virtual ~Agent();
 	/**Pure virtual function to be overriden by child class.
 		It executes the actions that the object will make in its given turn. This action includes move, breed, and die
 		\return If the object breeds and creates a child object, then it returns a pointer to the child object. Else, it returns NULL
 	*/
 	virtual Agent* act() = 0;
+	/**Copies the state of the object. Child classes with additional state override this function
+	\return The state of the object
+	*/
+	virtual AgentState getState();
+	/**Recreates an agent from a copy of its state and places it on the board
+	\param board The board on which the agent will reside
+	\param state The state of the agent, as returned by getState()
+	\return A pointer to a brand new Coyote or Roadrunner object
+	*/
+	static Agent* fromState(SimulationBoard* board, AgentState state);
 	/**Checks if the object is alive.
 	\return True if alive, false if dead
 	*/
 	bool isAlive();
+	/**Returns the location of the object in the board
+	\return The current location of the object
+	*/
+	Coordinates getLocation();
+	/**Returns the type of the object on the board
+	\return coyote or roadrunner
+	*/
+	BoardOccupantTypes getType();
+	/**Pure virtual function to be overriden by child class.
+		Used by the synchronous update mode. Computes the move and birth the object intends to make this time step without modifying the board,
+		which is treated as the read-only state of the previous time step. Only draws from the random stream of the intent, so the agents
+		can plan in any order, or in parallel.
+		\param intent The intent to fill in. Its priority and random stream have already been seeded by the caller
+	*/
+	virtual void planStep(AgentIntent &intent) = 0;
+	/**Pure virtual function to be overriden by child class.
+		Used by the synchronous update mode. Applies the outcome of the conflict resolution to the object's own state (location, countdowns,
+		alive flag). The board is not modified, and neither are the babies placed on it: the caller writes the cells that change into the
+		back buffer of the board.
+		\param intent The intent computed by planStep(), with its granted/eaten flags filled in
+		\return If the object gives birth, a pointer to the child object. Else, NULL
+	*/
+	virtual Agent* commitStep(const AgentIntent &intent) = 0;
 };
 
 
@@ -0,0 +1,115 @@
+#include "BoardLayout.h"
+#include <stdexcept>
+#include <cstring>
+#include <stdint.h>
+
+const char BoardLayout::binaryMagic[4] = { 'C', 'R', 'B', 'M' };
+
+BoardLayout::BoardLayout(const char* fileName) : file(fileName) {
+	numOfRows = 0;
+	numOfColumns = 0;
+	numOfRoadrunners = 0;
+	numOfCoyotes = 0;
+	binary = file.getSize() >= sizeof(binaryMagic) && memcmp(file.getData(), binaryMagic, sizeof(binaryMagic)) == 0;
+	std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> countAgent = [&](unsigned int, unsigned int, BoardOccupantTypes type) {
+		if (type == BoardOccupantTypes::roadrunner) {
+			numOfRoadrunners++;
+		} else {
+			numOfCoyotes++;
+		}
+	};
+	if (binary) {
+		uint32_t dimensions[2];
+		if (file.getSize() < sizeof(binaryMagic) + sizeof(dimensions)) {
+			throw std::invalid_argument("The layout file is too short.");
+		}
+		memcpy(dimensions, file.getData() + sizeof(binaryMagic), sizeof(dimensions));
+		numOfRows = dimensions[0];
+		numOfColumns = dimensions[1];
+		if (file.getSize() != sizeof(binaryMagic) + sizeof(dimensions) + (unsigned long long)numOfRows * numOfColumns) {
+			throw std::invalid_argument("The size of the layout file does not match its number of rows and columns.");
+		}
+		scanBinary(countAgent);
+	} else {
+		scanAscii(countAgent);
+	}
+	if (numOfRows == 0 || numOfColumns == 0) {
+		throw std::invalid_argument("The layout file has no cells.");
+	}
+}
+
+void BoardLayout::scanAscii(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit) {
+	const char* text = file.getData();
+	size_t size = file.getSize();
+	unsigned int row = 0;
+	unsigned int column = 0;
+	for (size_t i = 0; i <= size; i++) {
+		//the end of the file ends the last row, even without a newline
+		char glyph = i < size ? text[i] : '\n';
+		if (glyph == '\n') {
+			//blank lines do not count as rows
+			if (column == 0) {
+				continue;
+			}
+			if (row == 0) {
+				numOfColumns = column;
+			} else if (column != numOfColumns) {
+				throw std::invalid_argument("Row " + std::to_string(row + 1) + " of the layout file has a different number of cells than the first row.");
+			}
+			row++;
+			column = 0;
+		} else if (glyph == ' ' || glyph == '\t' || glyph == '\r') {
+			continue;
+		} else if (glyph == '-') {
+			column++;
+		} else if (glyph == 'C' || glyph == 'R') {
+			if (visit) {
+				visit(row, column, glyph == 'C' ? BoardOccupantTypes::coyote : BoardOccupantTypes::roadrunner);
+			}
+			column++;
+		} else {
+			throw std::invalid_argument(std::string("Unknown character '") + glyph + "' in the layout file.");
+		}
+	}
+	numOfRows = row;
+}
+
+void BoardLayout::scanBinary(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit) {
+	const unsigned char* cells = (const unsigned char*)file.getData() + sizeof(binaryMagic) + 2 * sizeof(uint32_t);
+	unsigned long numOfCells = (unsigned long)numOfRows * numOfColumns;
+	for (unsigned long cell = 0; cell < numOfCells; cell++) {
+		if (cells[cell] == (unsigned char)BoardOccupantTypes::unoccupied) {
+			continue;
+		}
+		if (cells[cell] > (unsigned char)BoardOccupantTypes::roadrunner) {
+			throw std::invalid_argument("Unknown cell value " + std::to_string((int)cells[cell]) + " in the layout file.");
+		}
+		if (visit) {
+			visit(cell / numOfColumns, cell % numOfColumns, (BoardOccupantTypes)cells[cell]);
+		}
+	}
+}
+
+unsigned int BoardLayout::getNumOfRows() {
+	return numOfRows;
+}
+
+unsigned int BoardLayout::getNumOfColumns() {
+	return numOfColumns;
+}
+
+unsigned int BoardLayout::getNumOfRoadrunners() {
+	return numOfRoadrunners;
+}
+
+unsigned int BoardLayout::getNumOfCoyotes() {
+	return numOfCoyotes;
+}
+
+void BoardLayout::visitAgents(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit) {
+	if (binary) {
+		scanBinary(visit);
+	} else {
+		scanAscii(visit);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef BOARDLAYOUT_H
+#define BOARDLAYOUT_H
+
+#include "SimulationBoard.h"
+#include "MappedFile.h"
+#include <functional>
+
+
+/**
+	The initial layout of a board, read from a map file so that an exact scenario can be replayed. Two formats are accepted:
+	- ASCII: one line per row, using the same glyphs as SimulationBoard::printBoard() ('C' for a coyote, 'R' for a roadrunner and '-'
+	for an empty cell). Spaces between glyphs and blank lines are ignored, so the output of printBoard() can be used as is
+	- Binary: the four characters "CRBM", the number of rows and the number of columns as 32-bit unsigned integers in the byte order of
+	the machine, then one byte per cell, row after row, holding the value of its BoardOccupantTypes
+	The file is mapped into memory rather than read, and is only walked once to validate it and once to place the agents
+*/
+class BoardLayout {
+private:
+	///The contents of the map file
+	MappedFile file;
+	///True if the file is in the binary format
+	bool binary;
+	///The number of rows in the layout
+	unsigned int numOfRows;
+	///The number of columns in the layout
+	unsigned int numOfColumns;
+	///The number of roadrunners in the layout
+	unsigned int numOfRoadrunners;
+	///The number of coyotes in the layout
+	unsigned int numOfCoyotes;
+
+	/**Walks the cells of an ASCII layout, checking that every row has the same number of cells. Throws an invalid_argument exception
+	if the layout is malformed
+	\param visit Called for every occupied cell with its row, column and occupant. May be empty
+	*/
+	void scanAscii(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit);
+
+	/**Walks the cells of a binary layout. Throws an invalid_argument exception if a cell holds an unknown value
+	\param visit Called for every occupied cell with its row, column and occupant. May be empty
+	*/
+	void scanBinary(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit);
+public:
+	///The four characters a binary map file starts with
+	static const char binaryMagic[4];
+
+	/**Opens and validates a map file. Throws an invalid_argument exception if the file cannot be opened or is malformed
+	\param fileName The name of the map file
+	*/
+	BoardLayout(const char* fileName);
+
+	/**Returns the number of rows in the layout
+	\return The number of rows
+	*/
+	unsigned int getNumOfRows();
+
+	/**Returns the number of columns in the layout
+	\return The number of columns
+	*/
+	unsigned int getNumOfColumns();
+
+	/**Returns the number of roadrunners in the layout
+	\return The number of roadrunners
+	*/
+	unsigned int getNumOfRoadrunners();
+
+	/**Returns the number of coyotes in the layout
+	\return The number of coyotes
+	*/
+	unsigned int getNumOfCoyotes();
+
+	/**Calls a function for every occupied cell of the layout, row after row
+	\param visit Called with the row, column and occupant of the cell
+	*/
+	void visitAgents(const std::function<void(unsigned int, unsigned int, BoardOccupantTypes)> &visit);
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "BoardRenderer.h"
+#include <iostream>
+#include <algorithm>
+
+const unsigned int BoardRenderer::maxZoom;
+
+/**Adds one row of cells to the per-column counters of each species. The cells are read as plain bytes so that the loop has no
+branches, and the pointers are declared not to overlap so that the compiler vectorizes the loop without a run-time overlap check
+*/
+static void addRowCounts(const unsigned char* __restrict__ rowCells, unsigned short* __restrict__ coyoteCounts, unsigned short* __restrict__ roadrunnerCounts, unsigned int numOfColumns) {
+	for (unsigned int column = 0; column < numOfColumns; column++) {
+		coyoteCounts[column] += rowCells[column] == (unsigned char)BoardOccupantTypes::coyote;
+		roadrunnerCounts[column] += rowCells[column] == (unsigned char)BoardOccupantTypes::roadrunner;
+	}
+}
+
+BoardRenderer::BoardRenderer(unsigned int numOfViewRows, unsigned int numOfViewColumns, unsigned int zoom) {
+	firstRow = 0;
+	firstColumn = 0;
+	this->numOfViewRows = numOfViewRows;
+	this->numOfViewColumns = numOfViewColumns;
+	this->zoom = std::max(1u, std::min(zoom, maxZoom));
+}
+
+char BoardRenderer::densityGlyph(unsigned int numOfCoyotes, unsigned int numOfRoadrunners, unsigned int numOfCells) {
+	if (numOfCoyotes == 0 && numOfRoadrunners == 0) {
+		return '-';
+	}
+	bool dense = 2 * (numOfCoyotes + numOfRoadrunners) >= numOfCells;
+	if (numOfCoyotes > numOfRoadrunners) {
+		return dense ? 'C' : 'c';
+	}
+	return dense ? 'R' : 'r';
+}
+
+void BoardRenderer::pan(int rowSteps, int columnSteps) {
+	//a window that fits the whole board has no size of its own, so it moves by half the size it would have at the default width
+	long rowStep = (long)std::max(numOfViewRows, 2u) * zoom / 2;
+	long columnStep = (long)std::max(numOfViewColumns, 2u) * zoom / 2;
+	firstRow = (unsigned int)std::max(0L, (long)firstRow + rowSteps * rowStep);
+	firstColumn = (unsigned int)std::max(0L, (long)firstColumn + columnSteps * columnStep);
+}
+
+void BoardRenderer::setOrigin(unsigned int row, unsigned int column) {
+	firstRow = row;
+	firstColumn = column;
+}
+
+void BoardRenderer::setZoom(unsigned int zoom) {
+	zoom = std::max(1u, std::min(zoom, maxZoom));
+	//keep the center of the window in place
+	long centerRow = firstRow + (long)numOfViewRows * this->zoom / 2;
+	long centerColumn = firstColumn + (long)numOfViewColumns * this->zoom / 2;
+	firstRow = (unsigned int)std::max(0L, centerRow - (long)numOfViewRows * zoom / 2);
+	firstColumn = (unsigned int)std::max(0L, centerColumn - (long)numOfViewColumns * zoom / 2);
+	this->zoom = zoom;
+}
+
+unsigned int BoardRenderer::getZoom() {
+	return zoom;
+}
+
+void BoardRenderer::clampToBoard(unsigned int boardFirstRow, unsigned int boardNumOfRows, unsigned int boardNumOfColumns, unsigned int &numOfRowsShown, unsigned int &numOfColumnsShown) {
+	numOfRowsShown = numOfViewRows == 0 ? boardNumOfRows : (unsigned int)std::min((unsigned long)numOfViewRows * zoom, (unsigned long)boardNumOfRows);
+	numOfColumnsShown = numOfViewColumns == 0 ? boardNumOfColumns : (unsigned int)std::min((unsigned long)numOfViewColumns * zoom, (unsigned long)boardNumOfColumns);
+	firstRow = std::max(boardFirstRow, std::min(firstRow, boardFirstRow + boardNumOfRows - numOfRowsShown));
+	firstColumn = std::min(firstColumn, boardNumOfColumns - numOfColumnsShown);
+}
+
+void BoardRenderer::printHeader(unsigned int numOfRowsShown, unsigned int numOfColumnsShown) {
+	std::cout << "Rows " << firstRow << "-" << firstRow + numOfRowsShown - 1 << ", columns " << firstColumn << "-" << firstColumn + numOfColumnsShown - 1;
+	if (zoom > 1) {
+		std::cout << ", one glyph per " << zoom << "x" << zoom << " cells";
+	}
+	std::cout << ":" << std::endl;
+}
+
+void BoardRenderer::countBand(SimulationBoard* board, unsigned int firstCountedRow, unsigned int endCountedRow, unsigned int numOfColumnsShown, unsigned long* counts) {
+	unsigned int numOfBlockColumns = (numOfColumnsShown + zoom - 1) / zoom;
+	std::fill(counts, counts + 2 * numOfBlockColumns, 0);
+	//an empty band is not read at all
+	if (board->isRegionEmpty(firstCountedRow, firstColumn, endCountedRow - firstCountedRow, numOfColumnsShown)) {
+		return;
+	}
+	const BoardOccupantTypes* cells = board->getCells();
+	unsigned long rowStride = board->getRowStride();
+	unsigned int rowOffset = board->getRowOffset();
+	coyoteColumnCounts.assign(numOfColumnsShown, 0);
+	roadrunnerColumnCounts.assign(numOfColumnsShown, 0);
+	for (unsigned int row = firstCountedRow; row < endCountedRow; row++) {
+		addRowCounts((const unsigned char*)(cells + (row - rowOffset) * rowStride + firstColumn), coyoteColumnCounts.data(), roadrunnerColumnCounts.data(), numOfColumnsShown);
+	}
+	const unsigned short* coyoteCounts = coyoteColumnCounts.data();
+	const unsigned short* roadrunnerCounts = roadrunnerColumnCounts.data();
+	for (unsigned int block = 0; block < numOfBlockColumns; block++) {
+		unsigned int blockFirstColumn = block * zoom;
+		unsigned int blockWidth = std::min(zoom, numOfColumnsShown - blockFirstColumn);
+		for (unsigned int column = blockFirstColumn; column < blockFirstColumn + blockWidth; column++) {
+			counts[2 * block] += coyoteCounts[column];
+			counts[2 * block + 1] += roadrunnerCounts[column];
+		}
+	}
+}
+
+void BoardRenderer::printBand(const unsigned long* counts, unsigned int bandHeight, unsigned int numOfColumnsShown) {
+	unsigned int numOfBlockColumns = (numOfColumnsShown + zoom - 1) / zoom;
+	line.resize(2 * numOfBlockColumns);
+	for (unsigned int block = 0; block < numOfBlockColumns; block++) {
+		unsigned int blockWidth = std::min(zoom, numOfColumnsShown - block * zoom);
+		line[2 * block] = densityGlyph(counts[2 * block], counts[2 * block + 1], bandHeight * blockWidth);
+		line[2 * block + 1] = ' ';
+	}
+	std::cout << line << std::endl;
+}
+
+void BoardRenderer::render(SimulationBoard* board) {
+	unsigned int numOfRowsShown, numOfColumnsShown;
+	clampToBoard(board->getRowOffset(), board->getNumOfRows(), board->getNumOfColumns(), numOfRowsShown, numOfColumnsShown);
+	if (numOfRowsShown == 0 || numOfColumnsShown == 0) {
+		std::cout << std::endl << std::endl;
+		return;
+	}
+	printHeader(numOfRowsShown, numOfColumnsShown);
+	blockCounts.resize(2 * ((numOfColumnsShown + zoom - 1) / zoom));
+	for (unsigned int bandRow = firstRow; bandRow < firstRow + numOfRowsShown; bandRow += zoom) {
+		unsigned int bandHeight = std::min(zoom, firstRow + numOfRowsShown - bandRow);
+		countBand(board, bandRow, bandRow + bandHeight, numOfColumnsShown, blockCounts.data());
+		printBand(blockCounts.data(), bandHeight, numOfColumnsShown);
+	}
+	std::cout << std::endl << std::endl;
+}
+
+std::vector<unsigned long> BoardRenderer::countWindow(SimulationBoard* board, unsigned int numOfBoardRows, unsigned int firstCountedRow, unsigned int endCountedRow) {
+	unsigned int numOfRowsShown, numOfColumnsShown;
+	clampToBoard(0, numOfBoardRows, board->getNumOfColumns(), numOfRowsShown, numOfColumnsShown);
+	unsigned long numOfBlocksPerBand = 2 * ((numOfColumnsShown + zoom - 1) / zoom);
+	std::vector<unsigned long> counts(numOfBlocksPerBand * ((numOfRowsShown + zoom - 1) / zoom), 0);
+	for (unsigned int bandRow = firstRow, band = 0; bandRow < firstRow + numOfRowsShown; bandRow += zoom, band++) {
+		//a band may straddle two strips, which each count their own part of it
+		unsigned int firstBandRow = std::max(bandRow, firstCountedRow);
+		unsigned int endBandRow = std::min(std::min(bandRow + zoom, firstRow + numOfRowsShown), endCountedRow);
+		if (firstBandRow < endBandRow) {
+			countBand(board, firstBandRow, endBandRow, numOfColumnsShown, counts.data() + band * numOfBlocksPerBand);
+		}
+	}
+	return counts;
+}
+
+void BoardRenderer::printCounts(unsigned int numOfBoardRows, unsigned int numOfBoardColumns, const std::vector<unsigned long> &counts) {
+	unsigned int numOfRowsShown, numOfColumnsShown;
+	clampToBoard(0, numOfBoardRows, numOfBoardColumns, numOfRowsShown, numOfColumnsShown);
+	if (numOfRowsShown == 0 || numOfColumnsShown == 0) {
+		std::cout << std::endl << std::endl;
+		return;
+	}
+	printHeader(numOfRowsShown, numOfColumnsShown);
+	unsigned long numOfBlocksPerBand = 2 * ((numOfColumnsShown + zoom - 1) / zoom);
+	for (unsigned int bandRow = firstRow, band = 0; bandRow < firstRow + numOfRowsShown; bandRow += zoom, band++) {
+		printBand(counts.data() + band * numOfBlocksPerBand, std::min(zoom, firstRow + numOfRowsShown - bandRow), numOfColumnsShown);
+	}
+	std::cout << std::endl << std::endl;
+}
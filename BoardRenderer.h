@@ -0,0 +1,136 @@
+#pragma once
+#ifndef BOARDRENDERER_H
+#define BOARDRENDERER_H
+
+#include "SimulationBoard.h"
+#include <vector>
+#include <string>
+
+
+/**
+	Prints a window of the board, for boards too large to print whole. The window has a movable origin, and can be zoomed out so that
+	each glyph stands for a block of zoom by zoom cells: '-' if the block is empty, otherwise the glyph of the species with more agents
+	in the block, in upper case if at least half of the block is occupied ('C', 'R') and in lower case otherwise ('c', 'r'). At zoom 1,
+	the glyphs are the same as those of SimulationBoard::printBoard().
+
+	Blocks are counted one band of zoom rows at a time: every row of the band is added column by column into per-column counters, a loop
+	the compiler turns into vector instructions, and the counters are then summed per block. Bands that the occupancy counts of the board
+	show to be empty are not read at all. A board split into strips is printed by having every strip count the blocks of its own rows
+	with countWindow(), so only the counts of the window are gathered, never the board itself.
+*/
+class BoardRenderer {
+private:
+	///The global index of the first row of the window
+	unsigned int firstRow;
+	///The first column of the window
+	unsigned int firstColumn;
+	///The number of rows of glyphs printed. 0 to fit the whole board
+	unsigned int numOfViewRows;
+	///The number of columns of glyphs printed. 0 to fit the whole board
+	unsigned int numOfViewColumns;
+	///The number of rows and columns of cells each glyph stands for
+	unsigned int zoom;
+	///The number of coyotes in each column of the band being counted
+	std::vector<unsigned short> coyoteColumnCounts;
+	///The number of roadrunners in each column of the band being counted
+	std::vector<unsigned short> roadrunnerColumnCounts;
+	///The number of coyotes then of roadrunners in each block of the band being printed
+	std::vector<unsigned long> blockCounts;
+	///The line of glyphs being built
+	std::string line;
+
+	/**Moves the window back inside the board if it lies partly outside of it
+	\param boardFirstRow The global index of the first row of the board
+	\param boardNumOfRows The number of rows in the board
+	\param boardNumOfColumns The number of columns in the board
+	\param numOfRowsShown Set to the number of rows of cells covered by the window
+	\param numOfColumnsShown Set to the number of columns of cells covered by the window
+	*/
+	void clampToBoard(unsigned int boardFirstRow, unsigned int boardNumOfRows, unsigned int boardNumOfColumns, unsigned int &numOfRowsShown, unsigned int &numOfColumnsShown);
+
+	/**Prints the line describing the rows and columns the window covers
+	\param numOfRowsShown The number of rows of cells covered by the window
+	\param numOfColumnsShown The number of columns of cells covered by the window
+	*/
+	void printHeader(unsigned int numOfRowsShown, unsigned int numOfColumnsShown);
+
+	/**Counts the agents of each species in the blocks of one band of the window, over some of the rows of the band
+	\param board The board. Must store the rows counted
+	\param firstCountedRow The global index of the first row counted
+	\param endCountedRow The global index one past the last row counted
+	\param numOfColumnsShown The number of columns of cells covered by the window
+	\param counts Set to the number of coyotes then of roadrunners in each block of the band
+	*/
+	void countBand(SimulationBoard* board, unsigned int firstCountedRow, unsigned int endCountedRow, unsigned int numOfColumnsShown, unsigned long* counts);
+
+	/**Prints one band of glyphs
+	\param counts The number of coyotes then of roadrunners in each block of the band
+	\param bandHeight The number of rows of cells in the band
+	\param numOfColumnsShown The number of columns of cells covered by the window
+	*/
+	void printBand(const unsigned long* counts, unsigned int bandHeight, unsigned int numOfColumnsShown);
+public:
+	///The largest zoom allowed, which keeps the per-column counters from overflowing
+	static const unsigned int maxZoom = 4096;
+
+	/**Constructor for BoardRenderer. The window starts at the top left corner of the board
+	\param numOfViewRows The number of rows of glyphs printed. 0 to fit the whole board
+	\param numOfViewColumns The number of columns of glyphs printed. 0 to fit the whole board
+	\param zoom The number of rows and columns of cells each glyph stands for
+	*/
+	BoardRenderer(unsigned int numOfViewRows, unsigned int numOfViewColumns, unsigned int zoom);
+
+	/**Returns the glyph of a block of cells
+	\param numOfCoyotes The number of coyotes in the block
+	\param numOfRoadrunners The number of roadrunners in the block
+	\param numOfCells The number of cells in the block
+	\return The glyph
+	*/
+	static char densityGlyph(unsigned int numOfCoyotes, unsigned int numOfRoadrunners, unsigned int numOfCells);
+
+	/**Moves the window by half of its size in each direction
+	\param rowSteps The number of half windows to move down (negative to move up)
+	\param columnSteps The number of half windows to move right (negative to move left)
+	*/
+	void pan(int rowSteps, int columnSteps);
+
+	/**Moves the origin of the window. It is moved back inside the board when the board is next printed
+	\param row The global index of the first row of the window
+	\param column The first column of the window
+	*/
+	void setOrigin(unsigned int row, unsigned int column);
+
+	/**Changes the number of rows and columns of cells each glyph stands for. The center of the window stays in place
+	\param zoom The new zoom. Clamped to 1..maxZoom
+	*/
+	void setZoom(unsigned int zoom);
+
+	/**Returns the number of rows and columns of cells each glyph stands for
+	\return The zoom
+	*/
+	unsigned int getZoom();
+
+	/**Prints the window of the board, preceded by a line describing the rows and columns it covers
+	\param board The board
+	*/
+	void render(SimulationBoard* board);
+
+	/**Counts the agents in every block of the window of a board split into strips, over the rows of one strip only. The window is
+	fitted to the whole board. The sums of the counts of every strip are printed with printCounts()
+	\param board The strip of the board
+	\param numOfBoardRows The number of rows in the whole board
+	\param firstCountedRow The global index of the first row owned by the strip
+	\param endCountedRow The global index one past the last row owned by the strip
+	\return The number of coyotes then of roadrunners in each block of the window, band after band
+	*/
+	std::vector<unsigned long> countWindow(SimulationBoard* board, unsigned int numOfBoardRows, unsigned int firstCountedRow, unsigned int endCountedRow);
+
+	/**Prints the window of a board split into strips, in the same format as render()
+	\param numOfBoardRows The number of rows in the whole board
+	\param numOfBoardColumns The number of columns in the board
+	\param counts The sums over every strip of the counts returned by countWindow()
+	*/
+	void printCounts(unsigned int numOfBoardRows, unsigned int numOfBoardColumns, const std::vector<unsigned long> &counts);
+};
+
+#endif
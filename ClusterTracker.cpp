@@ -0,0 +1,288 @@
+#include "ClusterTracker.h"
+
+ClusterTracker::ClusterTracker(unsigned int numOfRows, unsigned int numOfColumns) {
+	this->numOfRows = numOfRows;
+	this->numOfColumns = numOfColumns;
+	unsigned long numOfCells = (unsigned long)numOfRows * numOfColumns;
+	cellType.assign(numOfCells, BoardOccupantTypes::unoccupied);
+	cellNode.assign(numOfCells, -1);
+	searchMark.assign(numOfCells, 0);
+	numOfClusters[0] = 0;
+	numOfClusters[1] = 0;
+}
+
+int ClusterTracker::speciesIndex(BoardOccupantTypes type) {
+	return type == BoardOccupantTypes::coyote ? 0 : 1;
+}
+
+long ClusterTracker::find(long node) {
+	while (parent[node] != node) {
+		parent[node] = parent[parent[node]];
+		node = parent[node];
+	}
+	return node;
+}
+
+long ClusterTracker::createNode(unsigned long cell) {
+	long node = parent.size();
+	parent.push_back(node);
+	clusterSize.push_back(1);
+	cellNode[cell] = node;
+	return node;
+}
+
+void ClusterTracker::countCluster(int species, unsigned long size, int change) {
+	if (change > 0) {
+		sizeDistribution[species][size]++;
+		numOfClusters[species]++;
+	} else {
+		std::map<unsigned long, unsigned long>::iterator entry = sizeDistribution[species].find(size);
+		if (--(entry->second) == 0) {
+			sizeDistribution[species].erase(entry);
+		}
+		numOfClusters[species]--;
+	}
+}
+
+void ClusterTracker::unite(unsigned long firstCell, unsigned long secondCell) {
+	long firstRoot = find(cellNode[firstCell]);
+	long secondRoot = find(cellNode[secondCell]);
+	if (firstRoot == secondRoot) {
+		return;
+	}
+	int species = speciesIndex(cellType[firstCell]);
+	countCluster(species, clusterSize[firstRoot], -1);
+	countCluster(species, clusterSize[secondRoot], -1);
+	//union by size: the smaller tree is attached to the larger one
+	if (clusterSize[firstRoot] < clusterSize[secondRoot]) {
+		std::swap(firstRoot, secondRoot);
+	}
+	parent[secondRoot] = firstRoot;
+	clusterSize[firstRoot] += clusterSize[secondRoot];
+	countCluster(species, clusterSize[firstRoot], 1);
+}
+
+int ClusterTracker::neighborsOf(unsigned long cell, unsigned long neighbors[4]) {
+	int count = 0;
+	unsigned long row = cell / numOfColumns;
+	unsigned long column = cell % numOfColumns;
+	if (row > 0) {
+		neighbors[count++] = cell - numOfColumns;
+	}
+	if (row + 1 < numOfRows) {
+		neighbors[count++] = cell + numOfColumns;
+	}
+	if (column > 0) {
+		neighbors[count++] = cell - 1;
+	}
+	if (column + 1 < numOfColumns) {
+		neighbors[count++] = cell + 1;
+	}
+	return count;
+}
+
+void ClusterTracker::agentAdded(BoardOccupantTypes type, unsigned long cell) {
+	if (cellType[cell] != BoardOccupantTypes::unoccupied) {
+		agentRemoved(cell);
+	}
+	cellType[cell] = type;
+	createNode(cell);
+	countCluster(speciesIndex(type), 1, 1);
+	unsigned long neighbors[4];
+	int numOfNeighbors = neighborsOf(cell, neighbors);
+	for (int i = 0; i < numOfNeighbors; i++) {
+		if (cellType[neighbors[i]] == type) {
+			unite(cell, neighbors[i]);
+		}
+	}
+	if (parent.size() > 2 * cellType.size() + 1024) {
+		compact();
+	}
+}
+
+void ClusterTracker::agentRemoved(unsigned long cell) {
+	BoardOccupantTypes type = cellType[cell];
+	if (type == BoardOccupantTypes::unoccupied) {
+		return;
+	}
+	int species = speciesIndex(type);
+	long root = find(cellNode[cell]);
+
+	//the node stays in its tree as a tombstone; the cluster just loses one cell
+	countCluster(species, clusterSize[root], -1);
+	clusterSize[root]--;
+	if (clusterSize[root] > 0) {
+		countCluster(species, clusterSize[root], 1);
+	}
+	cellType[cell] = BoardOccupantTypes::unoccupied;
+	cellNode[cell] = -1;
+
+	//the cluster can only fall apart if the removed cell connected neighbors that are not connected around it
+	unsigned long startCells[4];
+	int numOfStartCells = disconnectedNeighbors(cell, type, startCells);
+	if (numOfStartCells >= 2) {
+		splitCluster(root, startCells, numOfStartCells);
+	}
+}
+
+int ClusterTracker::disconnectedNeighbors(unsigned long cell, BoardOccupantTypes type, unsigned long startCells[4]) {
+	//the eight surrounding cells, each next to the one before it; the even ones are the neighbors of the cell
+	static const int rowOffsets[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+	static const int columnOffsets[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+	long row = cell / numOfColumns;
+	long column = cell % numOfColumns;
+	bool sameSpecies[8];
+	int firstGap = -1;
+	for (int i = 0; i < 8; i++) {
+		long ringRow = row + rowOffsets[i];
+		long ringColumn = column + columnOffsets[i];
+		sameSpecies[i] = ringRow >= 0 && ringRow < (long)numOfRows && ringColumn >= 0 && ringColumn < (long)numOfColumns
+			&& cellType[ringRow * numOfColumns + ringColumn] == type;
+		if (!sameSpecies[i] && firstGap < 0) {
+			firstGap = i;
+		}
+	}
+	if (firstGap < 0) {
+		//the whole ring is a single run
+		startCells[0] = cell - numOfColumns;
+		return 1;
+	}
+	//walk the ring once, starting after a gap so that no run is cut in two
+	int numOfStartCells = 0;
+	bool runHasStartCell = false;
+	for (int step = 1; step <= 8; step++) {
+		int i = (firstGap + step) % 8;
+		if (!sameSpecies[i]) {
+			runHasStartCell = false;
+		} else if (i % 2 == 0 && !runHasStartCell) {
+			startCells[numOfStartCells++] = (row + rowOffsets[i]) * numOfColumns + column + columnOffsets[i];
+			runHasStartCell = true;
+		}
+	}
+	return numOfStartCells;
+}
+
+void ClusterTracker::splitCluster(long root, unsigned long startCells[4], int numOfStartCells) {
+	BoardOccupantTypes type = cellType[startCells[0]];
+	int species = speciesIndex(type);
+	//the search that each search was joined to, or the search itself if it leads its group
+	int joinedTo[4];
+	//the position in its queue of the next cell each search expands
+	unsigned long nextCell[4];
+	int numOfGroups = numOfStartCells;
+	for (int i = 0; i < numOfStartCells; i++) {
+		joinedTo[i] = i;
+		nextCell[i] = 0;
+		searchQueue[i].clear();
+		searchQueue[i].push_back(startCells[i]);
+		searchMark[startCells[i]] = i + 1;
+	}
+	while (numOfGroups > 1) {
+		for (int i = 0; i < numOfStartCells && numOfGroups > 1; i++) {
+			if (nextCell[i] == searchQueue[i].size()) {
+				continue;
+			}
+			int leader = i;
+			while (joinedTo[leader] != leader) {
+				leader = joinedTo[leader];
+			}
+			unsigned long neighbors[4];
+			int numOfNeighbors = neighborsOf(searchQueue[i][nextCell[i]++], neighbors);
+			for (int j = 0; j < numOfNeighbors; j++) {
+				if (cellType[neighbors[j]] != type) {
+					continue;
+				}
+				if (searchMark[neighbors[j]] == 0) {
+					searchMark[neighbors[j]] = i + 1;
+					searchQueue[i].push_back(neighbors[j]);
+					continue;
+				}
+				int otherLeader = searchMark[neighbors[j]] - 1;
+				while (joinedTo[otherLeader] != otherLeader) {
+					otherLeader = joinedTo[otherLeader];
+				}
+				if (otherLeader != leader) {
+					joinedTo[otherLeader] = leader;
+					numOfGroups--;
+				}
+			}
+			if (nextCell[i] < searchQueue[i].size()) {
+				continue;
+			}
+			//a group whose searches have all run out of cells has found a piece that is no longer connected to the others
+			bool exhausted = true;
+			unsigned long pieceSize = 0;
+			for (int j = 0; j < numOfStartCells; j++) {
+				int otherLeader = j;
+				while (joinedTo[otherLeader] != otherLeader) {
+					otherLeader = joinedTo[otherLeader];
+				}
+				if (otherLeader == leader) {
+					exhausted = exhausted && nextCell[j] == searchQueue[j].size();
+					pieceSize += searchQueue[j].size();
+				}
+			}
+			if (!exhausted) {
+				continue;
+			}
+			//the whole piece moves to a single new node, and the rest of the cluster keeps the old root
+			long pieceRoot = createNode(startCells[i]);
+			for (int j = 0; j < numOfStartCells; j++) {
+				int otherLeader = j;
+				while (joinedTo[otherLeader] != otherLeader) {
+					otherLeader = joinedTo[otherLeader];
+				}
+				if (otherLeader == leader) {
+					for (unsigned long k = 0; k < searchQueue[j].size(); k++) {
+						cellNode[searchQueue[j][k]] = pieceRoot;
+					}
+				}
+			}
+			clusterSize[pieceRoot] = pieceSize;
+			countCluster(species, pieceSize, 1);
+			countCluster(species, clusterSize[root], -1);
+			clusterSize[root] -= pieceSize;
+			countCluster(species, clusterSize[root], 1);
+			numOfGroups--;
+		}
+	}
+	for (int i = 0; i < numOfStartCells; i++) {
+		for (unsigned long j = 0; j < searchQueue[i].size(); j++) {
+			searchMark[searchQueue[i][j]] = 0;
+		}
+	}
+}
+
+void ClusterTracker::compact() {
+	std::vector<BoardOccupantTypes> types = cellType;
+	clear();
+	for (unsigned long cell = 0; cell < types.size(); cell++) {
+		if (types[cell] != BoardOccupantTypes::unoccupied) {
+			agentAdded(types[cell], cell);
+		}
+	}
+}
+
+void ClusterTracker::clear() {
+	std::fill(cellType.begin(), cellType.end(), BoardOccupantTypes::unoccupied);
+	std::fill(cellNode.begin(), cellNode.end(), -1);
+	parent.clear();
+	clusterSize.clear();
+	for (int species = 0; species < 2; species++) {
+		sizeDistribution[species].clear();
+		numOfClusters[species] = 0;
+	}
+}
+
+unsigned long ClusterTracker::getNumOfClusters(BoardOccupantTypes type) {
+	return numOfClusters[speciesIndex(type)];
+}
+
+unsigned long ClusterTracker::getLargestCluster(BoardOccupantTypes type) {
+	const std::map<unsigned long, unsigned long> &distribution = sizeDistribution[speciesIndex(type)];
+	return distribution.empty() ? 0 : distribution.rbegin()->first;
+}
+
+const std::map<unsigned long, unsigned long>& ClusterTracker::getSizeDistribution(BoardOccupantTypes type) {
+	return sizeDistribution[speciesIndex(type)];
+}
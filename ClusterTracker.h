@@ -0,0 +1,146 @@
+#pragma once
+#ifndef CLUSTERTRACKER_H
+#define CLUSTERTRACKER_H
+
+#include "SimulationBoard.h"
+#include <vector>
+#include <map>
+
+
+/**
+	Keeps track of the clusters (4-connected groups of cells occupied by the same species) of coyotes and roadrunners on the board.
+	The clusters are maintained incrementally with a union-find structure that is fed every change made to the board. Additions only
+	ever merge clusters. A removal can only split a cluster if the removed cell connected two of its neighbors of the same species that
+	are not connected through the eight cells around it. Only then is a search run, one from each of those neighbors, interleaved so that
+	it stops as soon as all of them have met or all but one have run out of cells. Its cost is bounded by the size of the pieces split off,
+	not by the size of the cluster.
+
+	Union-find cannot delete elements, so every occupied cell points to a node, and a removed cell leaves its node behind as a tombstone
+	that keeps the rest of its tree connected. The cells of a piece that is split off all point to a single new node. The nodes are
+	compacted once the tombstones outnumber the cells.
+*/
+class ClusterTracker {
+private:
+	///The number of rows in the board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The species occupying each cell, in row-major order
+	std::vector<BoardOccupantTypes> cellType;
+	///The union-find node of each occupied cell, or -1 if the cell is unoccupied
+	std::vector<long> cellNode;
+	///The parent of each node. A node is a root if it is its own parent
+	std::vector<long> parent;
+	///The number of occupied cells in the cluster of each root node
+	std::vector<unsigned long> clusterSize;
+	///For each species, the number of clusters of each size
+	std::map<unsigned long, unsigned long> sizeDistribution[2];
+	///For each species, the number of clusters
+	unsigned long numOfClusters[2];
+	///Scratch lists of the cells reached by each of the searches run after a removal, in the order they were reached
+	std::vector<unsigned long> searchQueue[4];
+	///Scratch marks of the searches run after a removal: 0 for a cell not reached yet, otherwise 1 plus the index of the search that reached it
+	std::vector<unsigned char> searchMark;
+
+	/**Returns the index used for a species in the per-species arrays
+	\param type coyote or roadrunner
+	\return 0 for coyotes, 1 for roadrunners
+	*/
+	static int speciesIndex(BoardOccupantTypes type);
+
+	/**Finds the root of the tree a node belongs to, halving the path on the way
+	\param node The node
+	\return The root node
+	*/
+	long find(long node);
+
+	/**Creates a new node for a cell, as a single-cell cluster
+	\param cell The cell
+	\return The new node
+	*/
+	long createNode(unsigned long cell);
+
+	/**Merges the clusters of two cells
+	\param firstCell The first cell
+	\param secondCell The second cell. Must be occupied by the same species as the first
+	*/
+	void unite(unsigned long firstCell, unsigned long secondCell);
+
+	/**Records that a cluster of the given size was created (by adding 1) or destroyed (by adding -1)
+	\param species The species index
+	\param size The size of the cluster
+	\param change 1 or -1
+	*/
+	void countCluster(int species, unsigned long size, int change);
+
+	/**Returns the neighbors (up, down, left, right) of a cell that lie inside the board
+	\param cell The cell
+	\param neighbors Filled with the neighboring cells
+	\return The number of neighbors
+	*/
+	int neighborsOf(unsigned long cell, unsigned long neighbors[4]);
+
+	/**Finds the neighbors of a removed cell that can only be connected through cells farther away. Walks around the eight cells that
+	surround the removed cell: neighbors joined by a run of cells of the same species are connected already
+	\param cell The removed cell
+	\param type The species of the removed cell
+	\param startCells Filled with one neighbor of the same species from each run
+	\return The number of runs that contain a neighbor of the same species
+	*/
+	int disconnectedNeighbors(unsigned long cell, BoardOccupantTypes type, unsigned long startCells[4]);
+
+	/**Splits off the pieces of a cluster that lost their connection to the rest of it when one of its cells was removed. Searches from
+	each of the given cells in turn, one cell at a time. Searches that meet are joined, and a group of searches that runs out of cells
+	before meeting the others has found a piece that is split off. The search stops as soon as one group is left
+	\param root The root node of the cluster
+	\param startCells Neighbors of the removed cell, from different runs of the ring around it
+	\param numOfStartCells The number of start cells, at least 2
+	*/
+	void splitCluster(long root, unsigned long startCells[4], int numOfStartCells);
+
+	/**Rebuilds all the nodes from cellType, dropping the tombstones
+	*/
+	void compact();
+public:
+	/**
+		The constructor for the ClusterTracker class. Starts with an empty board
+		\param numOfRows The number of rows in the board
+		\param numOfColumns The number of columns in the board
+	*/
+	ClusterTracker(unsigned int numOfRows, unsigned int numOfColumns);
+
+	/**Called when an agent is placed on an unoccupied cell
+	\param type The type of the agent
+	\param cell The row-major index of the cell
+	*/
+	void agentAdded(BoardOccupantTypes type, unsigned long cell);
+
+	/**Called when an agent is removed from a cell
+	\param cell The row-major index of the cell
+	*/
+	void agentRemoved(unsigned long cell);
+
+	/**Forgets every cluster, as if the board were empty
+	*/
+	void clear();
+
+	/**Returns the number of clusters of a species
+	\param type coyote or roadrunner
+	\return The number of clusters
+	*/
+	unsigned long getNumOfClusters(BoardOccupantTypes type);
+
+	/**Returns the size of the largest cluster of a species
+	\param type coyote or roadrunner
+	\return The number of cells in the largest cluster, or 0 if there are no clusters
+	*/
+	unsigned long getLargestCluster(BoardOccupantTypes type);
+
+	/**Returns the size distribution of the clusters of a species
+	\param type coyote or roadrunner
+	\return A map from cluster size to the number of clusters of that size
+	*/
+	const std::map<unsigned long, unsigned long>& getSizeDistribution(BoardOccupantTypes type);
+};
+
+#endif
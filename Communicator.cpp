@@ -0,0 +1,55 @@
+#include "Communicator.h"
+#include <cstring>
+
+std::vector<char> Communicator::exchange(int peer, const std::vector<char> &message) {
+	std::vector<char> received;
+	if (rank() < peer) {
+		send(peer, message);
+		received = receive(peer);
+	} else {
+		received = receive(peer);
+		send(peer, message);
+	}
+	return received;
+}
+
+void Communicator::broadcast(std::vector<char> &message, int root) {
+	if (rank() == root) {
+		for (int i = 0; i < size(); i++) {
+			if (i != root) {
+				send(i, message);
+			}
+		}
+	} else {
+		message = receive(root);
+	}
+}
+
+std::vector<std::vector<char>> Communicator::gather(const std::vector<char> &message, int root) {
+	std::vector<std::vector<char>> messages;
+	if (rank() == root) {
+		for (int i = 0; i < size(); i++) {
+			messages.push_back(i == root ? message : receive(i));
+		}
+	} else {
+		send(root, message);
+	}
+	return messages;
+}
+
+void Communicator::sumOverProcesses(std::vector<unsigned long> &values) {
+	std::vector<char> message(values.size() * sizeof(unsigned long));
+	memcpy(message.data(), values.data(), message.size());
+	std::vector<std::vector<char>> messages = gather(message, 0);
+	if (rank() == 0) {
+		for (unsigned int i = 1; i < messages.size(); i++) {
+			const unsigned long* otherValues = (const unsigned long*)messages[i].data();
+			for (unsigned int j = 0; j < values.size(); j++) {
+				values[j] += otherValues[j];
+			}
+		}
+		memcpy(message.data(), values.data(), message.size());
+	}
+	broadcast(message, 0);
+	memcpy(values.data(), message.data(), message.size());
+}
@@ -0,0 +1,68 @@
+#pragma once
+#ifndef COMMUNICATOR_H
+#define COMMUNICATOR_H
+
+#include <vector>
+
+
+/**
+	An abstract, MPI-style interface used by the processes of a sharded simulation to talk to each other. Each process has a rank between
+	0 and size() - 1. Child classes only implement point-to-point messaging; the collective operations are built on top of it, so a real
+	transport (for example MPI) can back the interface by overriding as much as it needs.
+*/
+class Communicator {
+public:
+	/**Virtual destructor for the Communicator class
+	*/
+	virtual ~Communicator() {}
+
+	/**Returns the rank of the calling process
+	\return A number between 0 and size() - 1
+	*/
+	virtual int rank() = 0;
+
+	/**Returns the number of processes taking part in the simulation
+	\return The number of processes
+	*/
+	virtual int size() = 0;
+
+	/**Sends a message to another process. May block until the other process receives it
+	\param destination The rank of the receiving process
+	\param message The bytes to send
+	*/
+	virtual void send(int destination, const std::vector<char> &message) = 0;
+
+	/**Receives the next message sent by another process. Blocks until the message arrives
+	\param source The rank of the sending process
+	\return The bytes received
+	*/
+	virtual std::vector<char> receive(int source) = 0;
+
+	/**Sends a message to a process and receives the message that process sends back in the same call. Both processes must call
+	exchange() with each other's rank. The process with the lower rank sends first, so the exchange never deadlocks
+	\param peer The rank of the other process
+	\param message The bytes to send
+	\return The bytes received from the other process
+	*/
+	virtual std::vector<char> exchange(int peer, const std::vector<char> &message);
+
+	/**Copies a message from the root process to every process. Must be called by every process
+	\param message On the root, the message to send. On the other processes, replaced by the received message
+	\param root The rank of the process that sends the message
+	*/
+	virtual void broadcast(std::vector<char> &message, int root);
+
+	/**Collects one message from every process on the root process. Must be called by every process
+	\param message The message sent by the calling process
+	\param root The rank of the process that collects the messages
+	\return On the root, the messages ordered by rank. Empty on the other processes
+	*/
+	virtual std::vector<std::vector<char>> gather(const std::vector<char> &message, int root);
+
+	/**Sums a list of values over all processes and hands the sums to every process. Must be called by every process
+	\param values The values of the calling process. Replaced by the sums
+	*/
+	virtual void sumOverProcesses(std::vector<unsigned long> &values);
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "ControlChannel.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+const unsigned int ControlChannel::stdinClient;
+
+ControlChannel::ControlChannel(bool readStdin, const std::string &socketPath) : stopping(false) {
+	nextClientId = stdinClient + 1;
+	listenSocket = -1;
+	this->socketPath = socketPath;
+	if (readStdin) {
+		clients[stdinClient] = std::make_pair(STDIN_FILENO, std::string());
+	}
+	if (!socketPath.empty()) {
+		struct sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (socketPath.length() >= sizeof(address.sun_path)) {
+			throw std::invalid_argument("The control socket path is too long.");
+		}
+		strcpy(address.sun_path, socketPath.c_str());
+		//a socket left behind by an earlier run would make bind() fail
+		unlink(socketPath.c_str());
+		listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listenSocket < 0 || bind(listenSocket, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listenSocket, 8) != 0) {
+			if (listenSocket >= 0) {
+				close(listenSocket);
+			}
+			throw std::invalid_argument("Unable to create the control socket " + socketPath + ".");
+		}
+	}
+	if (pipe(wakePipe) != 0) {
+		if (listenSocket >= 0) {
+			close(listenSocket);
+			unlink(socketPath.c_str());
+		}
+		throw std::invalid_argument("Unable to create the control channel.");
+	}
+	controlThread = std::thread(&ControlChannel::run, this);
+}
+
+ControlChannel::~ControlChannel() {
+	stopping.store(true);
+	wakeControlThread('s');
+	controlThread.join();
+	for (std::map<unsigned int, std::pair<int, std::string> >::iterator client = clients.begin(); client != clients.end(); ++client) {
+		if (client->first != stdinClient) {
+			close(client->second.first);
+		}
+	}
+	if (listenSocket >= 0) {
+		close(listenSocket);
+		unlink(socketPath.c_str());
+	}
+	close(wakePipe[0]);
+	close(wakePipe[1]);
+}
+
+void ControlChannel::run() {
+	std::vector<struct pollfd> watched;
+	std::vector<unsigned int> watchedClients;
+	char buffer[4096];
+	while (!stopping.load()) {
+		//the wake pipe and the listening socket come first, then one entry per client
+		watched.clear();
+		watchedClients.clear();
+		struct pollfd entry;
+		entry.events = POLLIN;
+		entry.fd = wakePipe[0];
+		watched.push_back(entry);
+		entry.fd = listenSocket;
+		watched.push_back(entry);
+		for (std::map<unsigned int, std::pair<int, std::string> >::iterator client = clients.begin(); client != clients.end(); ++client) {
+			entry.fd = client->second.first;
+			watched.push_back(entry);
+			watchedClients.push_back(client->first);
+		}
+		//poll() ignores entries with a negative file descriptor, such as a missing listening socket
+		if (poll(watched.data(), watched.size(), -1) < 0) {
+			continue;
+		}
+
+		if (watched[0].revents & POLLIN) {
+			if (read(wakePipe[0], buffer, sizeof(buffer)) < 0) {
+				continue;
+			}
+			sendReplies();
+		}
+		if (listenSocket >= 0 && (watched[1].revents & POLLIN)) {
+			int clientSocket = accept(listenSocket, NULL, NULL);
+			if (clientSocket >= 0) {
+				clients[nextClientId++] = std::make_pair(clientSocket, std::string());
+			}
+		}
+		for (unsigned int i = 0; i < watchedClients.size(); i++) {
+			if (watched[i + 2].revents == 0) {
+				continue;
+			}
+			ssize_t numOfBytes = read(watched[i + 2].fd, buffer, sizeof(buffer));
+			if (numOfBytes <= 0) {
+				//the client disconnected, or the standard input was closed. The simulation keeps running either way
+				if (watchedClients[i] != stdinClient) {
+					close(watched[i + 2].fd);
+				}
+				clients.erase(watchedClients[i]);
+				continue;
+			}
+			receiveFromClient(watchedClients[i], std::string(buffer, numOfBytes));
+		}
+	}
+	//the last replies, such as the one to quit, may have been queued after the wake-up that ended the loop was read
+	sendReplies();
+}
+
+void ControlChannel::sendReplies() {
+	std::pair<unsigned int, std::string> pendingReply;
+	while (replies.pop(pendingReply)) {
+		sendToClient(pendingReply.first, pendingReply.second);
+	}
+}
+
+void ControlChannel::wakeControlThread(char reason) {
+	//a write to a pipe whose ends are both open can only fail if it is interrupted by a signal. It is retried, since a lost wake-up
+	//would leave the control thread asleep with replies waiting
+	while (write(wakePipe[1], &reason, 1) < 0 && errno == EINTR) {
+	}
+}
+
+void ControlChannel::receiveFromClient(unsigned int clientId, const std::string &data) {
+	std::string &pending = clients[clientId].second;
+	pending += data;
+	size_t endOfLine;
+	while ((endOfLine = pending.find('\n')) != std::string::npos) {
+		std::string line = pending.substr(0, endOfLine);
+		pending.erase(0, endOfLine + 1);
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+		ControlCommand command;
+		std::string error = parseCommand(line, command);
+		if (!error.empty()) {
+			sendToClient(clientId, error + "\n");
+			continue;
+		}
+		command.clientId = clientId;
+		if (!commands.push(command)) {
+			sendToClient(clientId, "Too many commands waiting. Command ignored.\n");
+		}
+	}
+}
+
+void ControlChannel::sendToClient(unsigned int clientId, const std::string &text) {
+	if (clientId == stdinClient) {
+		std::cout << text << std::flush;
+		return;
+	}
+	std::map<unsigned int, std::pair<int, std::string> >::iterator client = clients.find(clientId);
+	//the client may have disconnected before its reply was ready
+	if (client == clients.end()) {
+		return;
+	}
+	size_t numOfBytesSent = 0;
+	while (numOfBytesSent < text.length()) {
+		//MSG_NOSIGNAL keeps a client that disconnects mid-reply from killing the process with SIGPIPE
+		ssize_t numOfBytes = send(client->second.first, text.data() + numOfBytesSent, text.length() - numOfBytesSent, MSG_NOSIGNAL);
+		if (numOfBytes <= 0) {
+			return;
+		}
+		numOfBytesSent += numOfBytes;
+	}
+}
+
+std::string ControlChannel::parseCommand(const std::string &line, ControlCommand &command) {
+	std::istringstream words(line);
+	std::string name;
+	words >> name;
+	command.argument = 0;
+	command.secondArgument = 0;
+	command.fileName = "";
+	if (name == "pause") {
+		command.type = ControlCommandTypes::pause;
+	} else if (name == "resume") {
+		command.type = ControlCommandTypes::resume;
+	} else if (name == "step") {
+		command.type = ControlCommandTypes::step;
+		//"step" on its own runs one time step
+		if (!(words >> command.argument)) {
+			command.argument = 1;
+		} else if (command.argument == 0) {
+			return "Usage: step [time steps, at least 1]";
+		}
+	} else if (name == "rate") {
+		command.type = ControlCommandTypes::rate;
+		if (!(words >> command.argument)) {
+			return "Usage: rate <time steps between printed boards, 0 for none>";
+		}
+	} else if (name == "stats") {
+		command.type = ControlCommandTypes::stats;
+	} else if (name == "checkpoint") {
+		command.type = ControlCommandTypes::checkpoint;
+		if (!(words >> command.fileName)) {
+			return "Usage: checkpoint <file>";
+		}
+	} else if (name == "view") {
+		command.type = ControlCommandTypes::view;
+		if (!(words >> command.argument >> command.secondArgument)) {
+			return "Usage: view <first row> <first column>";
+		}
+	} else if (name == "zoom") {
+		command.type = ControlCommandTypes::zoom;
+		if (!(words >> command.argument) || command.argument == 0) {
+			return "Usage: zoom <cells per glyph, at least 1>";
+		}
+	} else if (name == "quit") {
+		command.type = ControlCommandTypes::quit;
+	} else {
+		return "Unknown command \"" + name + "\". Commands: pause, resume, step [N], rate N, stats, checkpoint FILE, view ROW COLUMN, zoom K, quit";
+	}
+	return "";
+}
+
+bool ControlChannel::nextCommand(ControlCommand &command) {
+	return commands.pop(command);
+}
+
+void ControlChannel::reply(unsigned int clientId, const std::string &text) {
+	//every reply pushed before has woken the control thread, which empties the whole queue, so a full queue only has to be waited out
+	while (!replies.push(std::make_pair(clientId, text))) {
+		std::this_thread::yield();
+	}
+	wakeControlThread('r');
+}
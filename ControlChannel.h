@@ -0,0 +1,138 @@
+#pragma once
+#ifndef CONTROLCHANNEL_H
+#define CONTROLCHANNEL_H
+
+#include "SpscQueue.h"
+#include <string>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <utility>
+
+
+/**
+	An enum class that describes the commands that can be sent to a running simulation
+*/
+enum class ControlCommandTypes {
+	pause, ///< stop running time steps
+	resume, ///< run time steps continuously again
+	step, ///< run a number of time steps, then pause
+	rate, ///< print the board every given number of time steps (0 to stop printing it)
+	stats, ///< reply with the current population counts
+	checkpoint, ///< write the state of the simulation to a file
+	view, ///< move the window of the board that is printed
+	zoom, ///< change the number of cells each printed glyph stands for
+	quit ///< end the simulation
+};
+
+/**
+	A command read from the control channel, together with the client that sent it so that the reply can be sent back
+*/
+struct ControlCommand {
+	///The type of the command
+	ControlCommandTypes type;
+	///The number of time steps for step and rate, the row for view and the zoom for zoom. Unused by the other commands
+	unsigned long argument;
+	///The column for view. Unused by the other commands
+	unsigned long secondArgument;
+	///The name of the file for checkpoint. Empty for the other commands
+	std::string fileName;
+	///The client that sent the command. ControlChannel::stdinClient for the standard input
+	unsigned int clientId;
+};
+
+/**
+	Reads commands for a running simulation from the standard input and/or from clients of a local Unix socket, on a thread of its own.
+	The simulation thread takes the commands at time step boundaries through a lock-free queue, so checking for commands costs it one
+	atomic load per time step. Replies are handed back to the control thread through a second queue, so only the control thread ever
+	touches the sockets or prints replies to the standard output
+*/
+class ControlChannel {
+private:
+	///The commands waiting to be applied. Filled by the control thread, emptied by the simulation thread
+	SpscQueue<ControlCommand, 64> commands;
+	///The replies waiting to be sent to the clients. Filled by the simulation thread, emptied by the control thread
+	SpscQueue<std::pair<unsigned int, std::string>, 64> replies;
+	///The file descriptor of each connected client, and the part of a line received from it so far
+	std::map<unsigned int, std::pair<int, std::string> > clients;
+	///The id that will be given to the next client that connects
+	unsigned int nextClientId;
+	///A pipe used to wake the control thread up when there are replies to send or when the channel is being destroyed
+	int wakePipe[2];
+	///The socket on which clients connect, or -1 if there is no socket
+	int listenSocket;
+	///The path of the socket. Empty if there is no socket
+	std::string socketPath;
+	///Set when the channel is being destroyed
+	std::atomic<bool> stopping;
+	///The control thread
+	std::thread controlThread;
+
+	/**The body of the control thread. Waits for input from the clients and for replies to send, until the channel is destroyed
+	*/
+	void run();
+
+	/**Splits the data received from a client into lines and queues the command on each complete line
+	\param clientId The client the data was received from
+	\param data The data received
+	*/
+	void receiveFromClient(unsigned int clientId, const std::string &data);
+
+	/**Sends the replies waiting in the queue. Called on the control thread only
+	*/
+	void sendReplies();
+
+	/**Writes a byte to the wake pipe, so that the control thread looks at the replies and at the stopping flag
+	\param reason The byte written: 'r' for a reply, 's' for stopping
+	*/
+	void wakeControlThread(char reason);
+
+	/**Sends text to a client. Called on the control thread only
+	\param clientId The client
+	\param text The text to send
+	*/
+	void sendToClient(unsigned int clientId, const std::string &text);
+
+	/**Turns a line of text into a command
+	\param line The line, e.g. "step 100"
+	\param command Filled in with the command
+	\return An error message, or an empty string if the line is a valid command
+	*/
+	static std::string parseCommand(const std::string &line, ControlCommand &command);
+
+	/**Copy contructor for ControlChannel. Not implemented, since the channel owns a thread and file descriptors
+	*/
+	ControlChannel(ControlChannel const&);
+	/**Overloaded assignment operator for ControlChannel. Not implemented, since the channel owns a thread and file descriptors
+	*/
+	ControlChannel& operator=(ControlChannel const&);
+public:
+	///The client id of the standard input. Replies to it are printed to the standard output
+	static const unsigned int stdinClient = 0;
+
+	/**Starts the control thread. Throws an invalid_argument exception if the socket cannot be created
+	\param readStdin True if commands are read from the standard input
+	\param socketPath The path of the Unix socket to accept clients on, or an empty string for no socket. An existing file at the path is
+	replaced
+	*/
+	ControlChannel(bool readStdin, const std::string &socketPath);
+
+	/**Stops the control thread, disconnects the clients and removes the socket
+	*/
+	~ControlChannel();
+
+	/**Takes the next command sent to the simulation. Must only be called from the simulation thread
+	\param command Set to the command
+	\return False if no command is waiting
+	*/
+	bool nextCommand(ControlCommand &command);
+
+	/**Sends a reply to the client that sent a command, through the control thread. Waits for the control thread if too many replies are
+	already waiting, so that no reply is lost. Must only be called from the simulation thread
+	\param clientId The client that sent the command
+	\param text The reply, ending with a newline
+	*/
+	void reply(unsigned int clientId, const std::string &text);
+};
+
+#endif
@@ -5,6 +5,16 @@ Coyote::Coyote(SimulationBoard* board, Coordinates location) : Agent(board, loca
 	timeSinceLastMeal = 0;
 }
 
+Coyote::Coyote(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, unsigned int timeSinceLastMeal, bool addToBoard) : Agent(board, location, breedCountdown, BoardOccupantTypes::coyote, addToBoard) {
+	this->timeSinceLastMeal = timeSinceLastMeal;
+}
+
+AgentState Coyote::getState() {
+	AgentState state = Agent::getState();
+	state.timeSinceLastMeal = timeSinceLastMeal;
+	return state;
+}
+
 void Coyote::move() {
 	//if there is an adjacent roadrunner, then move to that location in the board
 	Coordinates newLocation = findRandomViableLocation(location, BoardOccupantTypes::roadrunner);
@@ -13,8 +23,8 @@ void Coyote::move() {
 		location = newLocation;
 		timeSinceLastMeal = 0;
 	} else {
-		//if there is no adjacent roadrunner, then move to a random adjacent unoccpied location
-		newLocation = findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
+		//if there is no adjacent roadrunner, then move to a random adjacent unoccpied location, or towards a roadrunner in pursuit mode
+		newLocation = chooseWanderLocation();
 		if (newLocation.initialized()) {
 			board->moveAgent(location, newLocation);
 			location = newLocation;
@@ -23,6 +33,16 @@ void Coyote::move() {
 	}
 }
 
+Coordinates Coyote::chooseWanderLocation() {
+	if (board->getPreyDistanceField() != NULL) {
+		unsigned long long mask = board->neighborMask(location, BoardOccupantTypes::unoccupied, type) & board->closerToPreyMask(location);
+		if (mask != 0) {
+			return stepInDirection(location, randomDirection(mask));
+		}
+	}
+	return findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
+}
+
 Agent* Coyote::breed() {
 	Coyote* babyCoyote = NULL;
 	//if there is an unoccupied adjacent location, then birth a baby coyote there
@@ -61,3 +81,42 @@ Agent* Coyote::act() {
 
 	return babyCoyote;
 }
+
+
+void Coyote::planStep(AgentIntent &intent) {
+	randomStream = &intent.randomState;
+	//prefer an adjacent roadrunner, otherwise a random adjacent unoccupied location
+	intent.moveTo = findRandomViableLocation(location, BoardOccupantTypes::roadrunner);
+	intent.eats = intent.moveTo.initialized();
+	if (!intent.eats) {
+		intent.moveTo = chooseWanderLocation();
+	}
+	//the coyote breeds this step if its countdown is about to reach 0. The baby is placed next to the coyote's previous location
+	if (breedCountdown <= 1) {
+		intent.birthAt = findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
+	}
+	randomStream = NULL;
+}
+
+Agent* Coyote::commitStep(const AgentIntent &intent) {
+	if (intent.moveGranted) {
+		location = intent.moveTo;
+		if (intent.eats) {
+			timeSinceLastMeal = 0;
+		}
+	}
+	timeSinceLastMeal++;
+	if (breedCountdown > 0) {
+		breedCountdown--;
+	}
+	Agent* babyCoyote = NULL;
+	if (breedCountdown == 0 && intent.birthGranted) {
+		breedCountdown = 8;
+		babyCoyote = new Coyote(board, intent.birthAt, 8, 0, false);
+	}
+	//the caller empties the cell in the back buffer, so dying only clears the alive flag
+	if (timeSinceLastMeal >= 4) {
+		alive = false;
+	}
+	return babyCoyote;
+}
@@ -16,6 +16,13 @@ private:
 		This function executes the move mechanism of the coyote object and makes adequate changes on the board to reflect the move.
 	*/
 	void move();
+	/**
+		Chooses where the coyote goes when no roadrunner is adjacent. If the board keeps a prey distance field (pursuit mode), a random
+		unoccupied neighbor closer to the nearest roadrunner in sight; otherwise, or if there is no such neighbor, a random unoccupied
+		neighbor
+	\return The chosen location. If no location found, an uninitialized location is returned
+	*/
+	Coordinates chooseWanderLocation();
 	/**
 	It executes the breed mechanism of the coyote object.
 	\return Returns a pointer to a brand new coyote spawned by this coyote. If breeding does not take place, a NULL pointer is returned
@@ -32,10 +39,32 @@ public:
 		\param location The location in which this coyote object will reside
 	*/
 	Coyote(SimulationBoard* board, Coordinates location);
+	/**
+		The constructor used to recreate a coyote from a copy of its state
+		\param board The board on which this coyote object will reside
+		\param location The location in which this coyote object will reside
+		\param breedCountdown The number of turns left until the coyote breeds
+		\param timeSinceLastMeal The number of turns since the coyote last ate
+		\param addToBoard False if the caller writes the coyote into the board itself
+	*/
+	Coyote(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, unsigned int timeSinceLastMeal, bool addToBoard = true);
+	/**Copies the state of the coyote, including the time since its last meal
+	\return The state of the coyote
+	*/
+	AgentState getState();
 	/** Executes the actions that the coyote object will make in its given turn. This action includes move, breed, and die.
 		\return If the coyote object breeds and creates a child object, then it returns a pointer to the child object. Else, it returns NULL
 	*/
 	Agent* act();
+	/**Computes the coyote's intended move (preferably onto an adjacent roadrunner) and birth against the previous-step board
+		\param intent The intent to fill in
+	*/
+	void planStep(AgentIntent &intent);
+	/**Applies the resolved intent: moves, eats, breeds and starves the coyote without touching the board
+		\param intent The resolved intent
+		\return If the coyote breeds, a pointer to the baby coyote, which is not on the board yet. Else, NULL
+	*/
+	Agent* commitStep(const AgentIntent &intent);
 };
 
 #endif
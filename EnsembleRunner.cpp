@@ -0,0 +1,202 @@
+#include "EnsembleRunner.h"
+#include "Simulation.h"
+#include "Hashing.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+///The number of standard errors of a 95% confidence interval
+static const double z95 = 1.96;
+
+EnsembleRunner::EnsembleRunner(const SimulationConfig &config, EnsembleMetricTypes metric, unsigned long horizon, double targetPrecision, unsigned long maxReplicas,
+	unsigned int numOfJobs, unsigned int masterSeed) {
+	this->config = config;
+	this->metric = metric;
+	this->horizon = horizon;
+	this->targetPrecision = targetPrecision;
+	this->minReplicas = std::min(30UL, maxReplicas);
+	this->maxReplicas = maxReplicas;
+	this->numOfJobs = std::max(1u, numOfJobs);
+	this->masterSeed = masterSeed;
+	numOfCensored = 0;
+	nextResultIndex = 0;
+	//the widest interval the results can give: the Wilson interval of a proportion is widest at 1/2, where its half-width is
+	//z / (2 sqrt(n + z^2)), and the sample variance of values between 0 and the horizon is at most horizon^2 / 4 * n / (n - 1)
+	double numOfResultsNeeded;
+	if (metric == EnsembleMetricTypes::coyoteExtinction) {
+		numOfResultsNeeded = z95 * z95 / (4 * targetPrecision * targetPrecision) - z95 * z95;
+	} else {
+		numOfResultsNeeded = 1 + z95 * z95 * horizon * horizon / (4 * targetPrecision * targetPrecision);
+	}
+	//one more, so that rounding in the half-width cannot leave the last result just short
+	numOfResultsNeeded = std::ceil(numOfResultsNeeded) + 1;
+	maxUsefulResults = numOfResultsNeeded < maxReplicas ? std::max(minReplicas, (unsigned long)numOfResultsNeeded) : maxReplicas;
+}
+
+EnsembleRunner::ReplicaResult EnsembleRunner::runReplica(unsigned long index) {
+	//replicas run side by side, so they must not all publish to the same telemetry file
+	config.telemetryFileName.clear();
+	config.framesFileName.clear();
+	Simulation simulation(config, (unsigned int)mixBits(((unsigned long long)masterSeed << 32) ^ index));
+	unsigned long numOfOpenCells = simulation.getBoard()->numOfHabitableCells(BoardOccupantTypes::roadrunner);
+	ReplicaResult result;
+	result.censored = false;
+	while (true) {
+		SimulationStats stats = simulation.getStats();
+		//each replica stops as soon as its outcome is known
+		if (metric == EnsembleMetricTypes::coyoteExtinction) {
+			if (stats.numOfCoyotes == 0) {
+				result.value = 1;
+				return result;
+			}
+			if (stats.stepNumber >= horizon) {
+				result.value = 0;
+				return result;
+			}
+		} else {
+			if (stats.numOfRoadrunners >= numOfOpenCells) {
+				result.value = stats.stepNumber;
+				return result;
+			}
+			//without roadrunners, the board can never fill up
+			if (stats.stepNumber >= horizon || stats.numOfRoadrunners == 0) {
+				result.value = horizon;
+				result.censored = true;
+				return result;
+			}
+		}
+		simulation.step(std::function<void()>());
+	}
+}
+
+EnsembleRunner::Replica EnsembleRunner::launch(unsigned long index) {
+	int fileDescriptors[2];
+	if (pipe(fileDescriptors) != 0) {
+		throw std::runtime_error("Unable to create a pipe for a replica.");
+	}
+	//anything still buffered would otherwise be printed again by the child
+	std::cout.flush();
+	pid_t process = fork();
+	if (process < 0) {
+		throw std::runtime_error("Unable to start a replica.");
+	}
+	if (process == 0) {
+		close(fileDescriptors[0]);
+		ReplicaResult result = runReplica(index);
+		ssize_t numOfBytes = write(fileDescriptors[1], &result, sizeof(result));
+		//_exit() skips the destructors and buffers the child inherited from the parent
+		_exit(numOfBytes == sizeof(result) ? 0 : 1);
+	}
+	close(fileDescriptors[1]);
+	Replica replica;
+	replica.index = index;
+	replica.process = process;
+	replica.resultPipe = fileDescriptors[0];
+	return replica;
+}
+
+double EnsembleRunner::halfWidth() {
+	return metric == EnsembleMetricTypes::coyoteExtinction ? statistics.proportionHalfWidth(z95) : statistics.meanHalfWidth(z95);
+}
+
+double EnsembleRunner::estimate() {
+	return metric == EnsembleMetricTypes::coyoteExtinction ? statistics.proportionCenter(z95) : statistics.getMean();
+}
+
+void EnsembleRunner::run() {
+	std::vector<Replica> running;
+	//results of replicas that finished before some replica launched earlier, waiting for their turn
+	std::map<unsigned long, ReplicaResult> waiting;
+	unsigned long numOfLaunched = 0;
+	unsigned long numOfFailed = 0;
+	bool converged = false;
+
+	while (true) {
+		//a replica launched past the results that are certain to be enough could never be taken. The limit only moves forward: a success
+		//taken moves nextResultIndex up by one and leaves one result fewer to be needed, and a failure taken moves it up alone
+		while (!converged && running.size() < numOfJobs && numOfLaunched < maxReplicas
+			&& numOfLaunched < nextResultIndex + (maxUsefulResults - std::min(maxUsefulResults, statistics.getCount()))) {
+			running.push_back(launch(numOfLaunched++));
+		}
+		if (running.empty()) {
+			break;
+		}
+		std::vector<struct pollfd> pipes(running.size());
+		for (unsigned int i = 0; i < running.size(); i++) {
+			pipes[i].fd = running[i].resultPipe;
+			pipes[i].events = POLLIN;
+		}
+		if (poll(pipes.data(), pipes.size(), -1) < 0) {
+			continue;
+		}
+		for (int i = running.size() - 1; i >= 0; i--) {
+			if (pipes[i].revents == 0) {
+				continue;
+			}
+			ReplicaResult result;
+			ssize_t numOfBytes = read(running[i].resultPipe, &result, sizeof(result));
+			close(running[i].resultPipe);
+			waitpid(running[i].process, NULL, 0);
+			if (numOfBytes == sizeof(result)) {
+				waiting[running[i].index] = result;
+			} else {
+				//a replica that died without a result is left out, rather than stalling the replicas after it
+				ReplicaResult missing = { NAN, false };
+				waiting[running[i].index] = missing;
+			}
+			running.erase(running.begin() + i);
+		}
+
+		//take the results in launch order, as far as they are contiguous
+		std::map<unsigned long, ReplicaResult>::iterator next;
+		while (!converged && (next = waiting.find(nextResultIndex)) != waiting.end()) {
+			if (std::isnan(next->second.value)) {
+				numOfFailed++;
+			} else {
+				statistics.add(next->second.value);
+				numOfCensored += next->second.censored;
+			}
+			waiting.erase(next);
+			nextResultIndex++;
+			converged = statistics.getCount() >= minReplicas && halfWidth() <= targetPrecision;
+		}
+
+		if (converged) {
+			//neither the replicas still running nor the results that came in ahead of their turn can change the answer any more
+			for (unsigned int i = 0; i < running.size(); i++) {
+				kill(running[i].process, SIGKILL);
+				waitpid(running[i].process, NULL, 0);
+				close(running[i].resultPipe);
+			}
+			std::cout << "Target precision reached. " << running.size() << " replicas still running were cancelled";
+			if (!waiting.empty()) {
+				std::cout << " and the results of " << waiting.size() << " replicas that finished out of turn were left out";
+			}
+			std::cout << "." << std::endl;
+			running.clear();
+			waiting.clear();
+		}
+	}
+
+	if (!converged) {
+		std::cout << "Stopped after " << numOfLaunched << " replicas without reaching the target precision." << std::endl;
+	}
+	if (metric == EnsembleMetricTypes::coyoteExtinction) {
+		std::cout << "Probability that the coyotes go extinct within " << horizon << " time steps: ";
+	} else {
+		std::cout << "Mean number of time steps until the board is full of roadrunners (runs that never fill it count as " << horizon << "): ";
+	}
+	std::cout << estimate() << " +/- " << halfWidth() << " (95% confidence), from " << statistics.getCount() << " replicas";
+	if (numOfCensored > 0) {
+		std::cout << ", " << numOfCensored << " of which never filled the board";
+	}
+	if (numOfFailed > 0) {
+		std::cout << ", " << numOfFailed << " replicas failed";
+	}
+	std::cout << "." << std::endl;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#ifndef ENSEMBLERUNNER_H
+#define ENSEMBLERUNNER_H
+
+#include "SimulationConfig.h"
+#include "OnlineStatistics.h"
+#include <vector>
+#include <map>
+#include <sys/types.h>
+
+
+/**
+	An enum class that describes the quantities an ensemble of simulations can estimate
+*/
+enum class EnsembleMetricTypes {
+	coyoteExtinction, ///< the probability that the coyotes go extinct within the horizon
+	saturationTime ///< the mean number of time steps until the board is full of roadrunners, counting the horizon for runs that never fill it
+};
+
+/**
+	Estimates a quantity over many independent runs (replicas) of the same simulation, run in parallel in child processes. Each replica
+	is seeded from the master seed and its index, so an ensemble can be reproduced. Replicas are launched until the confidence interval
+	of the estimate is narrow enough; the replicas still running at that point are killed, since their results are no longer needed.
+	No replica is launched past the point at which the interval is certain to be narrow enough whatever the results before it, so no
+	replica is ever run that could not change the estimate.
+
+	Results are taken in the order the replicas were launched, not the order they finish. Otherwise the replicas that end quickly (e.g.
+	early extinctions) would be over-represented at the moment the estimate is declared precise enough
+*/
+class EnsembleRunner {
+private:
+	///The settings of every replica
+	SimulationConfig config;
+	///The quantity estimated
+	EnsembleMetricTypes metric;
+	///The number of time steps after which a replica is stopped
+	unsigned long horizon;
+	///The half-width of the 95% confidence interval at which the ensemble stops
+	double targetPrecision;
+	///The fewest replicas the estimate is based on, so that the first few do not end the ensemble by chance
+	unsigned long minReplicas;
+	///The most replicas launched
+	unsigned long maxReplicas;
+	///The number of replicas run at the same time
+	unsigned int numOfJobs;
+	///The seed every replica seed is derived from
+	unsigned int masterSeed;
+	///The statistics of the results taken so far
+	OnlineStatistics statistics;
+	///The number of replicas that reached the horizon without an outcome (for saturationTime)
+	unsigned long numOfCensored;
+	///The index of the next replica whose result is taken. Results are taken in launch order, whether the replica succeeded or failed
+	unsigned long nextResultIndex;
+	///The number of results after which the ensemble stops whatever their values: the target precision is then certain to be reached
+	unsigned long maxUsefulResults;
+
+	/**
+		A running replica
+	*/
+	struct Replica {
+		///The index of the replica
+		unsigned long index;
+		///The process running it
+		pid_t process;
+		///The read end of the pipe the process sends its result through
+		int resultPipe;
+	};
+
+	/**
+		The result a replica sends back
+	*/
+	struct ReplicaResult {
+		///The value of the metric
+		double value;
+		///True if the replica reached the horizon without an outcome
+		bool censored;
+	};
+
+	/**Starts a replica in a child process
+	\param index The index of the replica
+	\return The running replica
+	*/
+	Replica launch(unsigned long index);
+
+	/**Runs a replica to its outcome. Called in the child process
+	\param index The index of the replica
+	\return The result
+	*/
+	ReplicaResult runReplica(unsigned long index);
+
+	/**Returns the half-width of the 95% confidence interval of the estimate
+	\return The half-width
+	*/
+	double halfWidth();
+
+	/**Returns the estimate
+	\return The estimate
+	*/
+	double estimate();
+public:
+	/**Constructor for EnsembleRunner
+	\param config The settings of every replica
+	\param metric The quantity estimated
+	\param horizon The number of time steps after which a replica is stopped
+	\param targetPrecision The half-width of the 95% confidence interval at which the ensemble stops
+	\param maxReplicas The most replicas launched
+	\param numOfJobs The number of replicas run at the same time
+	\param masterSeed The seed every replica seed is derived from
+	*/
+	EnsembleRunner(const SimulationConfig &config, EnsembleMetricTypes metric, unsigned long horizon, double targetPrecision, unsigned long maxReplicas,
+		unsigned int numOfJobs, unsigned int masterSeed);
+
+	/**Runs the ensemble and prints the estimate, its confidence interval and the number of replicas used
+	*/
+	void run();
+};
+
+#endif
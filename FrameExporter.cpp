@@ -0,0 +1,307 @@
+#include "FrameExporter.h"
+#include "TerrainMap.h"
+#include <stdexcept>
+#include <cstring>
+#include <zlib.h>
+
+const unsigned char FrameExporter::palette[6][3] = {
+	{ 232, 220, 184 },
+	{ 196, 82, 24 },
+	{ 32, 64, 200 },
+	{ 80, 80, 80 },
+	{ 140, 190, 230 },
+	{ 120, 170, 90 }
+};
+
+/**The palette index of an empty cell for each combination of TerrainFlags. A wall is drawn over water and cover, and water over cover
+*/
+static const unsigned char terrainColors[8] = { 0, 3, 4, 3, 5, 3, 4, 3 };
+
+/**Appends a 32-bit unsigned integer to a buffer, most significant byte first, as PNG stores them
+*/
+static void appendUint32(std::vector<unsigned char> &buffer, unsigned long value) {
+	buffer.push_back((value >> 24) & 0xff);
+	buffer.push_back((value >> 16) & 0xff);
+	buffer.push_back((value >> 8) & 0xff);
+	buffer.push_back(value & 0xff);
+}
+
+/**Appends a PNG chunk to a buffer: its length, its type, its data and the CRC of its type and data
+*/
+static void appendChunk(std::vector<unsigned char> &buffer, const char* type, const unsigned char* data, unsigned long size) {
+	appendUint32(buffer, size);
+	buffer.insert(buffer.end(), type, type + 4);
+	buffer.insert(buffer.end(), data, data + size);
+	unsigned long crc = crc32(0, (const Bytef*)type, 4);
+	//zlib takes a NULL buffer as a request for the initial CRC
+	if (size > 0) {
+		crc = crc32(crc, data, size);
+	}
+	appendUint32(buffer, crc);
+}
+
+FrameExporter::FrameExporter(const char* fileName, unsigned int numOfRows, unsigned int numOfColumns, const unsigned char* terrain, unsigned int scale, unsigned int numOfThreads) {
+	this->numOfRows = numOfRows;
+	this->numOfColumns = numOfColumns;
+	this->terrain = terrain;
+	this->scale = scale;
+	std::string name = fileName;
+	if (name.size() >= 4 && name.compare(name.size() - 4, 4, ".png") == 0) {
+		format = FrameFormats::png;
+	} else if (name.size() >= 4 && name.compare(name.size() - 4, 4, ".ppm") == 0) {
+		format = FrameFormats::ppm;
+	} else {
+		throw std::invalid_argument("The frame file name must end with .png or .ppm.");
+	}
+	if (scale == 0) {
+		throw std::invalid_argument("Invalid frame scale.");
+	}
+	//a whole frame is encoded in memory, and PNG limits the width and height to 31 bits
+	if ((unsigned long long)numOfRows * scale * numOfColumns * scale > (1ULL << 30)) {
+		throw std::invalid_argument("The frames would be too large. Use a smaller frame scale.");
+	}
+	//the frame number is written with "%d" or "%0Nd", as video encoders expect in the names of image sequences
+	size_t percent = name.find('%');
+	if (percent == std::string::npos) {
+		frameNumberWidth = -1;
+		fileNamePrefix = name;
+		stream.open(fileName, std::ios::binary | std::ios::trunc);
+		if (!stream.is_open()) {
+			throw std::invalid_argument(std::string("Unable to open ") + fileName + ".");
+		}
+	} else {
+		size_t end = percent + 1;
+		frameNumberWidth = 0;
+		while (end < name.size() && name[end] >= '0' && name[end] <= '9' && frameNumberWidth < 20) {
+			frameNumberWidth = frameNumberWidth * 10 + (name[end] - '0');
+			end++;
+		}
+		if (end >= name.size() || name[end] != 'd' || name.find('%', end) != std::string::npos) {
+			throw std::invalid_argument("The frame file name must hold at most one frame number, written %d or %0Nd.");
+		}
+		fileNamePrefix = name.substr(0, percent);
+		fileNameSuffix = name.substr(end + 1);
+	}
+	if (numOfThreads == 0) {
+		numOfThreads = 1;
+	}
+	//enough frames to keep every worker busy while the writer catches up
+	maxFramesInFlight = 2 * numOfThreads + 2;
+	numOfFramesCaptured = 0;
+	numOfFramesWritten = 0;
+	stopping = false;
+	for (unsigned int i = 0; i < numOfThreads; i++) {
+		workers.push_back(std::thread(&FrameExporter::encodeFrames, this));
+	}
+	writer = std::thread(&FrameExporter::writeFrames, this);
+}
+
+FrameExporter::~FrameExporter() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobQueued.notify_all();
+	frameEncoded.notify_all();
+	//the workers encode the snapshots left in the queue before they return, and the writer writes every frame
+	for (unsigned int i = 0; i < workers.size(); i++) {
+		workers[i].join();
+	}
+	writer.join();
+}
+
+void FrameExporter::capture(const BoardOccupantTypes* cells) {
+	std::unique_lock<std::mutex> lock(mutex);
+	//the simulation only waits here if the workers and the writer have fallen a full queue of frames behind
+	frameWritten.wait(lock, [&]() { return numOfFramesCaptured - numOfFramesWritten < maxFramesInFlight || !writeError.empty(); });
+	if (!writeError.empty()) {
+		throw std::runtime_error(writeError);
+	}
+	FrameJob job;
+	job.index = numOfFramesCaptured++;
+	if (!freeBuffers.empty()) {
+		job.cells.swap(freeBuffers.back());
+		freeBuffers.pop_back();
+	}
+	//the copy is the only part of a frame made on the simulation thread, and it is made without holding the lock
+	lock.unlock();
+	job.cells.assign(cells, cells + (unsigned long)numOfRows * numOfColumns);
+	lock.lock();
+	jobs.push_back(std::move(job));
+	lock.unlock();
+	jobQueued.notify_one();
+}
+
+void FrameExporter::encodeFrames() {
+	while (true) {
+		FrameJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobQueued.wait(lock, [&]() { return !jobs.empty() || stopping; });
+			if (jobs.empty()) {
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		std::vector<unsigned char> image;
+		std::string error;
+		try {
+			if (format == FrameFormats::png) {
+				encodePng(job.cells, image);
+			} else {
+				encodePpm(job.cells, image);
+			}
+		} catch (std::exception &e) {
+			error = e.what();
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			freeBuffers.push_back(std::move(job.cells));
+			if (!error.empty() && writeError.empty()) {
+				writeError = error;
+			}
+			//a frame that failed to encode is still handed to the writer, empty, so that the frames after it are not held up
+			encodedFrames[job.index].swap(image);
+		}
+		frameEncoded.notify_one();
+	}
+}
+
+void FrameExporter::writeFrames() {
+	for (unsigned long index = 0; ; index++) {
+		std::vector<unsigned char> image;
+		bool failed;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			frameEncoded.wait(lock, [&]() { return encodedFrames.count(index) != 0 || (stopping && numOfFramesWritten == numOfFramesCaptured); });
+			if (encodedFrames.count(index) == 0) {
+				return;
+			}
+			image.swap(encodedFrames[index]);
+			encodedFrames.erase(index);
+			failed = !writeError.empty();
+		}
+		//once a frame is lost, the rest are dropped rather than written with a gap
+		std::string error;
+		if (!failed) {
+			if (frameNumberWidth < 0) {
+				stream.write((const char*)image.data(), image.size());
+				//a video encoder reading from a pipe gets every frame as soon as it is ready
+				stream.flush();
+				if (!stream) {
+					error = "Unable to write " + fileNamePrefix + ".";
+				}
+			} else {
+				std::string name = frameFileName(index);
+				std::ofstream file(name.c_str(), std::ios::binary | std::ios::trunc);
+				file.write((const char*)image.data(), image.size());
+				file.close();
+				if (!file) {
+					error = "Unable to write " + name + ".";
+				}
+			}
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error.empty() && writeError.empty()) {
+				writeError = error;
+			}
+			numOfFramesWritten++;
+		}
+		frameWritten.notify_one();
+	}
+}
+
+void FrameExporter::drawRow(const std::vector<BoardOccupantTypes> &cells, unsigned int row, unsigned char* pixels) {
+	const BoardOccupantTypes* rowCells = cells.data() + (unsigned long)row * numOfColumns;
+	const unsigned char* rowTerrain = terrain != NULL ? terrain + (unsigned long)row * numOfColumns : NULL;
+	for (unsigned int column = 0; column < numOfColumns; column++) {
+		//the palette starts with the occupant types, so an occupied cell is drawn with the value of its occupant
+		unsigned char color = (unsigned char)rowCells[column];
+		if (color == 0 && rowTerrain != NULL) {
+			color = terrainColors[rowTerrain[column] & TerrainFlags::all];
+		}
+		memset(pixels + (unsigned long)column * scale, color, scale);
+	}
+}
+
+void FrameExporter::encodePpm(const std::vector<BoardOccupantTypes> &cells, std::vector<unsigned char> &image) {
+	unsigned long width = (unsigned long)numOfColumns * scale;
+	unsigned long height = (unsigned long)numOfRows * scale;
+	std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+	image.resize(header.size() + 3 * width * height);
+	memcpy(image.data(), header.data(), header.size());
+	std::vector<unsigned char> colors(width);
+	unsigned char* pixels = image.data() + header.size();
+	for (unsigned int row = 0; row < numOfRows; row++) {
+		drawRow(cells, row, colors.data());
+		unsigned char* line = pixels + (unsigned long)row * scale * 3 * width;
+		for (unsigned long x = 0; x < width; x++) {
+			memcpy(line + 3 * x, palette[colors[x]], 3);
+		}
+		//the other lines of the row of blocks are the same
+		for (unsigned int i = 1; i < scale; i++) {
+			memcpy(line + i * 3 * width, line, 3 * width);
+		}
+	}
+}
+
+void FrameExporter::encodePng(const std::vector<BoardOccupantTypes> &cells, std::vector<unsigned char> &image) {
+	unsigned long width = (unsigned long)numOfColumns * scale;
+	unsigned long height = (unsigned long)numOfRows * scale;
+	//each line of pixels is preceded by its filter type. The first line of a row of blocks is stored as is (filter 0); the other lines
+	//are stored as their difference with the line above (filter 2, "up"), which is all zeros and compresses to almost nothing
+	std::vector<unsigned char> lines((width + 1) * height, 0);
+	for (unsigned int row = 0; row < numOfRows; row++) {
+		unsigned char* line = lines.data() + (unsigned long)row * scale * (width + 1);
+		drawRow(cells, row, line + 1);
+		for (unsigned int i = 1; i < scale; i++) {
+			line[i * (width + 1)] = 2;
+		}
+	}
+	//the board is made of long runs of the same few colors, which run-length matching compresses nearly as well as a full search
+	//and several times faster
+	z_stream deflateStream;
+	memset(&deflateStream, 0, sizeof(deflateStream));
+	if (deflateInit2(&deflateStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15, 8, Z_RLE) != Z_OK) {
+		throw std::runtime_error("Unable to compress a frame.");
+	}
+	std::vector<unsigned char> compressed(deflateBound(&deflateStream, lines.size()));
+	deflateStream.next_in = lines.data();
+	deflateStream.avail_in = lines.size();
+	deflateStream.next_out = compressed.data();
+	deflateStream.avail_out = compressed.size();
+	int result = deflate(&deflateStream, Z_FINISH);
+	compressed.resize(deflateStream.total_out);
+	deflateEnd(&deflateStream);
+	if (result != Z_STREAM_END) {
+		throw std::runtime_error("Unable to compress a frame.");
+	}
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	image.assign(signature, signature + sizeof(signature));
+	std::vector<unsigned char> header;
+	appendUint32(header, width);
+	appendUint32(header, height);
+	//8 bits per pixel, indexed color, deflate, adaptive filtering, no interlacing
+	const unsigned char format[5] = { 8, 3, 0, 0, 0 };
+	header.insert(header.end(), format, format + sizeof(format));
+	appendChunk(image, "IHDR", header.data(), header.size());
+	appendChunk(image, "PLTE", &palette[0][0], sizeof(palette));
+	appendChunk(image, "IDAT", compressed.data(), compressed.size());
+	appendChunk(image, "IEND", NULL, 0);
+}
+
+std::string FrameExporter::frameFileName(unsigned long index) {
+	std::string number = std::to_string(index);
+	if ((int)number.size() < frameNumberWidth) {
+		number.insert(0, frameNumberWidth - number.size(), '0');
+	}
+	return fileNamePrefix + number + fileNameSuffix;
+}
+
+unsigned long FrameExporter::getNumOfFramesCaptured() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return numOfFramesCaptured;
+}
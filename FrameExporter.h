@@ -0,0 +1,165 @@
+#pragma once
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include "SimulationBoard.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+
+
+/**
+	An enum class that describes the image formats frames can be written in
+*/
+enum class FrameFormats {
+	ppm, ///< binary PPM (P6): uncompressed RGB, which video encoders read directly
+	png ///< indexed-color PNG, compressed with zlib
+};
+
+/**
+	Writes the board as a sequence of images, one per captured time step, with every cell drawn as a block of scale x scale pixels in the
+	color of its occupant (or of its terrain, if it is empty). The frames are written either to numbered files, or one after the other to
+	a single file, which can be a named pipe read by a video encoder.
+
+	The simulation thread only copies the board into a snapshot buffer and queues it. A pool of worker threads turns the snapshots into
+	images, and a writer thread writes the images out in the order they were captured, whichever worker finishes first. Snapshot buffers
+	are recycled, and only a bounded number of frames are in flight at once: the simulation only waits if the encoding falls that far
+	behind
+*/
+class FrameExporter {
+private:
+	/**
+		A board snapshot waiting to be encoded
+	*/
+	struct FrameJob {
+		///The index of the frame: 0 for the first frame captured
+		unsigned long index;
+		///The occupants of every cell at the time of the capture
+		std::vector<BoardOccupantTypes> cells;
+	};
+
+	///The format the frames are written in
+	FrameFormats format;
+	///The number of rows in the board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The TerrainFlags of every cell of the board, or NULL if the board has no terrain
+	const unsigned char* terrain;
+	///The number of pixels on each side of the block drawn for a cell
+	unsigned int scale;
+	///The part of the file name before the frame number. The whole file name if the frames go to a single file
+	std::string fileNamePrefix;
+	///The part of the file name after the frame number
+	std::string fileNameSuffix;
+	///The number of digits the frame number is padded to with zeros. -1 if the frames go to a single file
+	int frameNumberWidth;
+	///The file all the frames are written to, if they go to a single file
+	std::ofstream stream;
+	///The most frames captured but not yet written
+	unsigned long maxFramesInFlight;
+	///The number of frames captured so far
+	unsigned long numOfFramesCaptured;
+	///The number of frames written so far
+	unsigned long numOfFramesWritten;
+	///The snapshots waiting for a worker
+	std::deque<FrameJob> jobs;
+	///The encoded frames waiting for the writer, by index
+	std::map<unsigned long, std::vector<unsigned char> > encodedFrames;
+	///Snapshot buffers that are free to be reused
+	std::vector<std::vector<BoardOccupantTypes> > freeBuffers;
+	///Set when the exporter is being destroyed and no more frames will be captured
+	bool stopping;
+	///The reason the writer failed, or empty if it has not failed
+	std::string writeError;
+	///Guards all the members above that are shared between the threads
+	std::mutex mutex;
+	///Signals the workers that a snapshot has been queued or that the exporter is stopping
+	std::condition_variable jobQueued;
+	///Signals the writer that a frame has been encoded or that the exporter is stopping
+	std::condition_variable frameEncoded;
+	///Signals the simulation thread that a frame has been written
+	std::condition_variable frameWritten;
+	///The threads that encode the frames
+	std::vector<std::thread> workers;
+	///The thread that writes the frames out
+	std::thread writer;
+
+	/**The body of a worker thread. Encodes snapshots until the exporter stops and no snapshot is left
+	*/
+	void encodeFrames();
+
+	/**The body of the writer thread. Writes the encoded frames in order until the exporter stops and every frame has been written
+	*/
+	void writeFrames();
+
+	/**Draws one row of cells as one palette index per pixel, each cell repeated scale times
+	\param cells The occupants of every cell
+	\param row The row to draw
+	\param pixels Set to the palette indices of the row of pixels. Must hold numOfColumns * scale bytes
+	*/
+	void drawRow(const std::vector<BoardOccupantTypes> &cells, unsigned int row, unsigned char* pixels);
+
+	/**Encodes a snapshot as a PPM image
+	\param cells The occupants of every cell
+	\param image Set to the contents of the image file
+	*/
+	void encodePpm(const std::vector<BoardOccupantTypes> &cells, std::vector<unsigned char> &image);
+
+	/**Encodes a snapshot as a PNG image. Throws a runtime_error exception if zlib fails
+	\param cells The occupants of every cell
+	\param image Set to the contents of the image file
+	*/
+	void encodePng(const std::vector<BoardOccupantTypes> &cells, std::vector<unsigned char> &image);
+
+	/**Returns the name of the file a frame is written to
+	\param index The index of the frame
+	\return The file name, with the frame number in place of the pattern
+	*/
+	std::string frameFileName(unsigned long index);
+
+	/**Copy contructor for FrameExporter. Not implemented, since the threads point to the object
+	*/
+	FrameExporter(FrameExporter const&);
+	/**Overloaded assignment operator for FrameExporter. Not implemented, since the threads point to the object
+	*/
+	FrameExporter& operator=(FrameExporter const&);
+public:
+	///The color of each palette index, as red, green and blue: an empty cell, a coyote, a roadrunner, then a wall, water and cover
+	static const unsigned char palette[6][3];
+
+	/**Constructor for FrameExporter. Starts the worker and writer threads. Throws an invalid_argument exception if the file name is
+	invalid, if the single file cannot be opened or if the frames would be too large
+	\param fileName Where the frames are written. Must end with ".png" or ".ppm", which sets the format. A "%d" or "%0Nd" in the name is
+	replaced by the frame number (padded with zeros to N digits), giving one file per frame. Without it, every frame goes to the same file
+	\param numOfRows The number of rows in the board
+	\param numOfColumns The number of columns in the board
+	\param terrain The TerrainFlags of every cell of the board, in row-major order, or NULL if the board has no terrain. Must stay valid as
+	long as the exporter exists
+	\param scale The number of pixels on each side of the block drawn for a cell
+	\param numOfThreads The number of worker threads. 0 for one
+	*/
+	FrameExporter(const char* fileName, unsigned int numOfRows, unsigned int numOfColumns, const unsigned char* terrain, unsigned int scale, unsigned int numOfThreads);
+
+	/**Destructor for FrameExporter. Waits until every frame captured has been written, then stops the threads
+	*/
+	~FrameExporter();
+
+	/**Queues a snapshot of the board to be written as the next frame. Only waits if too many frames are already in flight. Throws a
+	runtime_error exception if writing an earlier frame failed
+	\param cells The board buffer, in row-major order
+	*/
+	void capture(const BoardOccupantTypes* cells);
+
+	/**Returns the number of frames captured so far
+	\return The number of frames
+	*/
+	unsigned long getNumOfFramesCaptured();
+};
+
+#endif
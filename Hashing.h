@@ -0,0 +1,19 @@
+#pragma once
+#ifndef HASHING_H
+#define HASHING_H
+
+
+/**
+	Scrambles the bits of a 64-bit value (the finalizer of the SplitMix64 generator). Nearby inputs give unrelated outputs, so the result
+	can be used as a random key derived from a counter, or as a seed derived from another seed
+	\param value The value to scramble
+	\return The scrambled value
+*/
+inline unsigned long long mixBits(unsigned long long value) {
+	value += 0x9E3779B97F4A7C15ULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const char* fileName) {
+	data = NULL;
+	size = 0;
+	int fileDescriptor = open(fileName, O_RDONLY);
+	if (fileDescriptor < 0) {
+		throw std::invalid_argument(std::string("Unable to open ") + fileName + ".");
+	}
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0) {
+		close(fileDescriptor);
+		throw std::invalid_argument(std::string("Unable to read ") + fileName + ".");
+	}
+	size = fileStatus.st_size;
+	//an empty file cannot be mapped, and there is nothing to map anyway
+	if (size > 0) {
+		void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mapping == MAP_FAILED) {
+			close(fileDescriptor);
+			throw std::invalid_argument(std::string("Unable to map ") + fileName + " into memory.");
+		}
+		data = (const char*)mapping;
+	}
+	//the mapping stays valid after the file is closed
+	close(fileDescriptor);
+}
+
+MappedFile::~MappedFile() {
+	if (data != NULL) {
+		munmap((void*)data, size);
+	}
+}
+
+const char* MappedFile::getData() {
+	return data;
+}
+
+size_t MappedFile::getSize() {
+	return size;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+
+/**
+	A read-only view of the contents of a file, mapped into memory instead of read into a buffer. Pages are loaded by the operating
+	system as they are touched, so large files cost nothing to open. The file is unmapped when the object is destroyed
+*/
+class MappedFile {
+private:
+	///The first byte of the file, or NULL if the file is empty
+	const char* data;
+	///The size of the file in bytes
+	size_t size;
+
+	/**Copy contructor for MappedFile. Not implemented, since two objects must not unmap the same memory
+	*/
+	MappedFile(MappedFile const&);
+	/**Overloaded assignment operator for MappedFile. Not implemented, since two objects must not unmap the same memory
+	*/
+	MappedFile& operator=(MappedFile const&);
+public:
+	/**Maps a file into memory. Throws an invalid_argument exception if the file cannot be opened or mapped
+	\param fileName The name of the file
+	*/
+	MappedFile(const char* fileName);
+
+	/**Destructor for MappedFile. Unmaps the file
+	*/
+	~MappedFile();
+
+	/**Returns a pointer to the contents of the file. The pointer stays valid as long as the object exists
+	\return The first byte of the file, or NULL if the file is empty
+	*/
+	const char* getData();
+
+	/**Returns the size of the file
+	\return The size of the file in bytes
+	*/
+	size_t getSize();
+};
+
+#endif
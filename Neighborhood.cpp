@@ -0,0 +1,75 @@
+#include "Neighborhood.h"
+#include <stdexcept>
+#include <cstdlib>
+#include <string>
+
+constexpr int VonNeumannStencil::rowOffsets[4];
+constexpr int VonNeumannStencil::columnOffsets[4];
+constexpr int MooreStencil::rowOffsets[8];
+constexpr int MooreStencil::columnOffsets[8];
+
+Neighborhood::Neighborhood() : Neighborhood(NeighborhoodTypes::vonNeumann, 1) {
+
+}
+
+Neighborhood::Neighborhood(NeighborhoodTypes type, unsigned int radius) {
+	this->type = type;
+	size = 0;
+	reach = 1;
+	if (type == NeighborhoodTypes::moore) {
+		for (unsigned int i = 0; i < MooreStencil::getSize(); i++) {
+			addNeighbor(MooreStencil::getRowOffset(i), MooreStencil::getColumnOffset(i));
+		}
+		return;
+	}
+	for (unsigned int i = 0; i < VonNeumannStencil::getSize(); i++) {
+		addNeighbor(VonNeumannStencil::getRowOffset(i), VonNeumannStencil::getColumnOffset(i));
+	}
+	if (type == NeighborhoodTypes::vonNeumann) {
+		return;
+	}
+	if (radius < 1 || radius > maxRadius) {
+		throw std::invalid_argument("The neighborhood radius must be between 1 and " + std::to_string(maxRadius) + ".");
+	}
+	reach = radius;
+	//the cells two or more steps away come after the four adjacent ones, nearest first
+	for (int distance = 2; distance <= (int)radius; distance++) {
+		for (int rowOffset = -distance; rowOffset <= distance; rowOffset++) {
+			int columnOffset = distance - std::abs(rowOffset);
+			addNeighbor(rowOffset, -columnOffset);
+			if (columnOffset != 0) {
+				addNeighbor(rowOffset, columnOffset);
+			}
+		}
+	}
+}
+
+void Neighborhood::addNeighbor(int rowOffset, int columnOffset) {
+	rowOffsets[size] = rowOffset;
+	columnOffsets[size] = columnOffset;
+	size++;
+}
+
+NeighborhoodTypes Neighborhood::getType() const {
+	return type;
+}
+
+unsigned int Neighborhood::getSize() const {
+	return size;
+}
+
+unsigned int Neighborhood::getReach() const {
+	return reach;
+}
+
+int Neighborhood::getRowOffset(unsigned int i) const {
+	return rowOffsets[i];
+}
+
+int Neighborhood::getColumnOffset(unsigned int i) const {
+	return columnOffsets[i];
+}
+
+unsigned long long Neighborhood::getAllNeighbors() const {
+	return size == 64 ? ~0ULL : (1ULL << size) - 1;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef NEIGHBORHOOD_H
+#define NEIGHBORHOOD_H
+
+
+/**
+	An enum class that describes the shapes of neighborhood agents can use to look around, move and breed
+*/
+enum class NeighborhoodTypes {
+	vonNeumann, ///< the four cells up, down, left and right
+	moore, ///< the eight cells around, diagonals included
+	radius ///< every cell within a given number of steps up, down, left and right
+};
+
+/**
+	The von Neumann stencil, fixed at compile time so that loops over it can be unrolled. Neighbor i is at (row + getRowOffset(i),
+	column + getColumnOffset(i)), in the order of the bits of a neighbor mask: up, down, left, right
+*/
+struct VonNeumannStencil {
+	///The change in row of each neighbor
+	static constexpr int rowOffsets[4] = { -1, 1, 0, 0 };
+	///The change in column of each neighbor
+	static constexpr int columnOffsets[4] = { 0, 0, -1, 1 };
+
+	/**\return The number of neighbors*/
+	static unsigned int getSize() { return 4; }
+	/**\return The largest change in row or column of a neighbor*/
+	static unsigned int getReach() { return 1; }
+	/**\param i The index of the neighbor \return The change in row of the neighbor*/
+	static int getRowOffset(unsigned int i) { return rowOffsets[i]; }
+	/**\param i The index of the neighbor \return The change in column of the neighbor*/
+	static int getColumnOffset(unsigned int i) { return columnOffsets[i]; }
+};
+
+/**
+	The Moore stencil, fixed at compile time so that loops over it can be unrolled. The first four neighbors are those of the von Neumann
+	stencil, followed by the diagonals: up-left, up-right, down-left, down-right
+*/
+struct MooreStencil {
+	///The change in row of each neighbor
+	static constexpr int rowOffsets[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	///The change in column of each neighbor
+	static constexpr int columnOffsets[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+	/**\return The number of neighbors*/
+	static unsigned int getSize() { return 8; }
+	/**\return The largest change in row or column of a neighbor*/
+	static unsigned int getReach() { return 1; }
+	/**\param i The index of the neighbor \return The change in row of the neighbor*/
+	static int getRowOffset(unsigned int i) { return rowOffsets[i]; }
+	/**\param i The index of the neighbor \return The change in column of the neighbor*/
+	static int getColumnOffset(unsigned int i) { return columnOffsets[i]; }
+};
+
+/**
+	The neighborhood used by a board, chosen at run time. It has the same interface as the compile-time stencils, so that the same
+	templated code serves the common stencils, unrolled, and any other neighborhood, as a plain loop.
+
+	Neighbors are numbered in the order of the bits of a neighbor mask. The first four are always up, down, left and right, so a
+	neighbor mask of the von Neumann neighborhood reads the same in every neighborhood
+*/
+class Neighborhood {
+public:
+	///The largest radius allowed, which keeps the number of neighbors within the 64 bits of a neighbor mask
+	static const unsigned int maxRadius = 5;
+	///The largest number of neighbors
+	static const unsigned int maxSize = 2 * maxRadius * (maxRadius + 1);
+private:
+	///The shape of the neighborhood
+	NeighborhoodTypes type;
+	///The number of neighbors
+	unsigned int size;
+	///The largest change in row or column of a neighbor
+	unsigned int reach;
+	///The change in row of each neighbor
+	int rowOffsets[maxSize];
+	///The change in column of each neighbor
+	int columnOffsets[maxSize];
+
+	/**Adds a neighbor to the end of the list
+	\param rowOffset The change in row of the neighbor
+	\param columnOffset The change in column of the neighbor
+	*/
+	void addNeighbor(int rowOffset, int columnOffset);
+public:
+	/**Default constructor for Neighborhood. Creates the von Neumann neighborhood
+	*/
+	Neighborhood();
+
+	/**Constructor for Neighborhood. Throws an invalid_argument exception if the radius is out of range
+	\param type The shape of the neighborhood
+	\param radius The number of steps a neighbor can be away, for the radius shape. Must be between 1 and maxRadius. Ignored by the
+	other shapes
+	*/
+	Neighborhood(NeighborhoodTypes type, unsigned int radius);
+
+	/**Returns the shape of the neighborhood
+	\return The shape
+	*/
+	NeighborhoodTypes getType() const;
+
+	/**Returns the number of neighbors
+	\return The number of neighbors
+	*/
+	unsigned int getSize() const;
+
+	/**Returns the largest change in row or column of a neighbor
+	\return The reach of the neighborhood
+	*/
+	unsigned int getReach() const;
+
+	/**Returns the change in row of a neighbor
+	\param i The index of the neighbor
+	\return The change in row
+	*/
+	int getRowOffset(unsigned int i) const;
+
+	/**Returns the change in column of a neighbor
+	\param i The index of the neighbor
+	\return The change in column
+	*/
+	int getColumnOffset(unsigned int i) const;
+
+	/**Returns the neighbor mask with every neighbor set
+	\return The mask
+	*/
+	unsigned long long getAllNeighbors() const;
+};
+
+#endif
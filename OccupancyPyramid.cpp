@@ -0,0 +1,192 @@
+#include "OccupancyPyramid.h"
+#include <queue>
+#include <algorithm>
+
+OccupancyPyramid::OccupancyPyramid(unsigned int numOfRows, unsigned int numOfColumns) {
+	this->numOfRows = numOfRows;
+	this->numOfColumns = numOfColumns;
+	unsigned long span = tileSize;
+	//add levels until one tile covers the whole board
+	while (true) {
+		Level level;
+		level.span = span;
+		level.numOfTileRows = (numOfRows + span - 1) / span;
+		level.numOfTileColumns = (numOfColumns + span - 1) / span;
+		level.counts.assign(2 * (unsigned long)level.numOfTileRows * level.numOfTileColumns, 0);
+		levels.push_back(level);
+		if (level.numOfTileRows <= 1 && level.numOfTileColumns <= 1) {
+			break;
+		}
+		span *= fanout;
+	}
+}
+
+int OccupancyPyramid::speciesIndex(BoardOccupantTypes type) {
+	return type == BoardOccupantTypes::coyote ? 0 : 1;
+}
+
+unsigned int OccupancyPyramid::tileCount(unsigned int level, unsigned long tileRow, unsigned long tileColumn, BoardOccupantTypes type) {
+	return levels[level].counts[2 * (tileRow * levels[level].numOfTileColumns + tileColumn) + speciesIndex(type)];
+}
+
+void OccupancyPyramid::cellChanged(unsigned int row, unsigned int column, BoardOccupantTypes oldType, BoardOccupantTypes newType) {
+	if (oldType == newType) {
+		return;
+	}
+	for (unsigned int i = 0; i < levels.size(); i++) {
+		unsigned long tile = 2 * ((row / levels[i].span) * levels[i].numOfTileColumns + column / levels[i].span);
+		if (oldType != BoardOccupantTypes::unoccupied) {
+			levels[i].counts[tile + speciesIndex(oldType)]--;
+		}
+		if (newType != BoardOccupantTypes::unoccupied) {
+			levels[i].counts[tile + speciesIndex(newType)]++;
+		}
+	}
+}
+
+void OccupancyPyramid::rebuild(const BoardOccupantTypes* cells) {
+	for (unsigned int i = 0; i < levels.size(); i++) {
+		std::fill(levels[i].counts.begin(), levels[i].counts.end(), 0);
+	}
+	for (unsigned int row = 0; row < numOfRows; row++) {
+		for (unsigned int column = 0; column < numOfColumns; column++) {
+			cellChanged(row, column, BoardOccupantTypes::unoccupied, cells[(unsigned long)row * numOfColumns + column]);
+		}
+	}
+}
+
+void OccupancyPyramid::countInTile(const BoardOccupantTypes* cells, unsigned int level, unsigned long tileRow, unsigned long tileColumn, BoardOccupantTypes type,
+	unsigned long firstRow, unsigned long firstColumn, unsigned long endRow, unsigned long endColumn, unsigned long &total, unsigned long limit) {
+	unsigned long span = levels[level].span;
+	unsigned long tileFirstRow = tileRow * span;
+	unsigned long tileFirstColumn = tileColumn * span;
+	unsigned long tileEndRow = std::min(tileFirstRow + span, (unsigned long)numOfRows);
+	unsigned long tileEndColumn = std::min(tileFirstColumn + span, (unsigned long)numOfColumns);
+	if (total >= limit || tileEndRow <= firstRow || tileFirstRow >= endRow || tileEndColumn <= firstColumn || tileFirstColumn >= endColumn) {
+		return;
+	}
+	unsigned int count = tileCount(level, tileRow, tileColumn, type);
+	if (count == 0) {
+		return;
+	}
+	//a tile entirely inside the rectangle is counted as a whole
+	if (tileFirstRow >= firstRow && tileEndRow <= endRow && tileFirstColumn >= firstColumn && tileEndColumn <= endColumn) {
+		total += count;
+		return;
+	}
+	//a level 0 tile that straddles the border is scanned cell by cell
+	if (level == 0) {
+		for (unsigned long row = std::max(tileFirstRow, firstRow); row < std::min(tileEndRow, endRow); row++) {
+			const BoardOccupantTypes* rowCells = cells + row * numOfColumns;
+			for (unsigned long column = std::max(tileFirstColumn, firstColumn); column < std::min(tileEndColumn, endColumn); column++) {
+				total += rowCells[column] == type;
+			}
+		}
+		return;
+	}
+	for (unsigned long childRow = tileRow * fanout; childRow < std::min((tileRow + 1) * fanout, (unsigned long)levels[level - 1].numOfTileRows); childRow++) {
+		for (unsigned long childColumn = tileColumn * fanout; childColumn < std::min((tileColumn + 1) * fanout, (unsigned long)levels[level - 1].numOfTileColumns); childColumn++) {
+			countInTile(cells, level - 1, childRow, childColumn, type, firstRow, firstColumn, endRow, endColumn, total, limit);
+		}
+	}
+}
+
+unsigned long OccupancyPyramid::countInRect(const BoardOccupantTypes* cells, BoardOccupantTypes type, unsigned int firstRow, unsigned int firstColumn,
+	unsigned int numOfRectRows, unsigned int numOfRectColumns, unsigned long limit) {
+	unsigned long total = 0;
+	if (numOfRows == 0 || numOfColumns == 0) {
+		return 0;
+	}
+	unsigned long endRow = std::min((unsigned long)firstRow + numOfRectRows, (unsigned long)numOfRows);
+	unsigned long endColumn = std::min((unsigned long)firstColumn + numOfRectColumns, (unsigned long)numOfColumns);
+	countInTile(cells, levels.size() - 1, 0, 0, type, firstRow, firstColumn, endRow, endColumn, total, limit);
+	return std::min(total, limit);
+}
+
+/**
+	A tile or a cell waiting to be visited by findNearest(), with a lower bound of its distance to the location searched from
+*/
+struct NearestCandidate {
+	///The distance to the nearest cell of the tile, or to the cell itself
+	unsigned long distance;
+	///The level of the tile, or -1 for a single cell
+	int level;
+	///The row of the tile in its level, or of the cell
+	unsigned long row;
+	///The column of the tile in its level, or of the cell
+	unsigned long column;
+
+	/**Orders candidates so that the priority queue hands out the nearest first
+	\param other The candidate to compare with
+	\return True if this candidate is farther than the other one
+	*/
+	bool operator<(const NearestCandidate &other) const {
+		return distance > other.distance;
+	}
+};
+
+/**Returns the distance from a location to the nearest cell of a span of rows or columns
+*/
+static unsigned long distanceToSpan(unsigned long position, unsigned long first, unsigned long end) {
+	if (position < first) {
+		return first - position;
+	}
+	return position >= end ? position - end + 1 : 0;
+}
+
+Coordinates OccupancyPyramid::findNearest(const BoardOccupantTypes* cells, BoardOccupantTypes type, unsigned int row, unsigned int column) {
+	std::priority_queue<NearestCandidate> candidates;
+	NearestCandidate top = { 0, (int)levels.size() - 1, 0, 0 };
+	if (numOfRows > 0 && numOfColumns > 0 && tileCount(top.level, 0, 0, type) > 0) {
+		candidates.push(top);
+	}
+	while (!candidates.empty()) {
+		NearestCandidate candidate = candidates.top();
+		candidates.pop();
+		//every candidate left is at least as far, since tile distances are lower bounds of the distances of their cells
+		if (candidate.level < 0) {
+			return Coordinates(candidate.row, candidate.column);
+		}
+		unsigned long span = levels[candidate.level].span;
+		if (candidate.level == 0) {
+			//only the nearest matching cell of the tile can be the answer
+			NearestCandidate best = { 0, -1, 0, 0 };
+			bool found = false;
+			for (unsigned long cellRow = candidate.row * span; cellRow < std::min((candidate.row + 1) * span, (unsigned long)numOfRows); cellRow++) {
+				for (unsigned long cellColumn = candidate.column * span; cellColumn < std::min((candidate.column + 1) * span, (unsigned long)numOfColumns); cellColumn++) {
+					if (cells[cellRow * numOfColumns + cellColumn] != type) {
+						continue;
+					}
+					unsigned long distance = distanceToSpan(row, cellRow, cellRow + 1) + distanceToSpan(column, cellColumn, cellColumn + 1);
+					if (!found || distance < best.distance) {
+						best.distance = distance;
+						best.row = cellRow;
+						best.column = cellColumn;
+						found = true;
+					}
+				}
+			}
+			if (found) {
+				candidates.push(best);
+			}
+			continue;
+		}
+		const Level &children = levels[candidate.level - 1];
+		for (unsigned long childRow = candidate.row * fanout; childRow < std::min((candidate.row + 1) * fanout, (unsigned long)children.numOfTileRows); childRow++) {
+			for (unsigned long childColumn = candidate.column * fanout; childColumn < std::min((candidate.column + 1) * fanout, (unsigned long)children.numOfTileColumns); childColumn++) {
+				if (tileCount(candidate.level - 1, childRow, childColumn, type) == 0) {
+					continue;
+				}
+				NearestCandidate child = { distanceToSpan(row, childRow * children.span, (childRow + 1) * children.span)
+					+ distanceToSpan(column, childColumn * children.span, (childColumn + 1) * children.span), candidate.level - 1, childRow, childColumn };
+				candidates.push(child);
+			}
+		}
+	}
+	Coordinates notFound;
+	return notFound;
+}
+
+unsigned int OccupancyPyramid::getNumOfLevels() {
+	return levels.size();
+}
@@ -0,0 +1,126 @@
+#pragma once
+#ifndef OCCUPANCYPYRAMID_H
+#define OCCUPANCYPYRAMID_H
+
+#include "SimulationBoard.h"
+#include <vector>
+
+
+/**
+	Counts the coyotes and roadrunners in square tiles of the board at several scales. Level 0 splits the board into tiles of tileSize by
+	tileSize cells, and each higher level groups fanout by fanout tiles of the level below, up to a level made of a single tile. Every
+	change to the board updates one count per level, and region queries only look at the cells of the tiles that straddle the border of
+	the region, skipping the tiles that are entirely inside it or entirely empty.
+
+	Rows are indices into the board buffer; SimulationBoard converts global rows before calling in.
+*/
+class OccupancyPyramid {
+public:
+	///The number of rows and columns of cells in a level 0 tile
+	static const unsigned int tileSize = 8;
+	///The number of rows and columns of tiles of one level grouped into a tile of the next level
+	static const unsigned int fanout = 4;
+private:
+	/**
+		The counts of one level of the pyramid
+	*/
+	struct Level {
+		///The number of rows of tiles
+		unsigned int numOfTileRows;
+		///The number of columns of tiles
+		unsigned int numOfTileColumns;
+		///The number of rows and columns of cells covered by a tile
+		unsigned long span;
+		///The number of coyotes and of roadrunners in each tile, two entries per tile in row-major order
+		std::vector<unsigned int> counts;
+	};
+
+	///The number of rows in the board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The levels, from the finest (level 0) to the coarsest (a single tile)
+	std::vector<Level> levels;
+
+	/**Returns the index used for a species in the counts
+	\param type coyote or roadrunner
+	\return 0 for coyotes, 1 for roadrunners
+	*/
+	static int speciesIndex(BoardOccupantTypes type);
+
+	/**Returns the count of a species in a tile
+	\param level The level of the tile
+	\param tileRow The row of the tile in its level
+	\param tileColumn The column of the tile in its level
+	\param type coyote or roadrunner
+	\return The number of agents of the species in the tile
+	*/
+	unsigned int tileCount(unsigned int level, unsigned long tileRow, unsigned long tileColumn, BoardOccupantTypes type);
+
+	/**Counts a species in the part of a tile that lies inside a rectangle, descending into the child tiles that straddle its border
+	\param cells The board buffer
+	\param level The level of the tile
+	\param tileRow The row of the tile in its level
+	\param tileColumn The column of the tile in its level
+	\param type coyote or roadrunner
+	\param firstRow The first row of the rectangle
+	\param firstColumn The first column of the rectangle
+	\param endRow One past the last row of the rectangle
+	\param endColumn One past the last column of the rectangle
+	\param total The count so far, to which the count in the tile is added
+	\param limit The count at which the search stops
+	*/
+	void countInTile(const BoardOccupantTypes* cells, unsigned int level, unsigned long tileRow, unsigned long tileColumn, BoardOccupantTypes type,
+		unsigned long firstRow, unsigned long firstColumn, unsigned long endRow, unsigned long endColumn, unsigned long &total, unsigned long limit);
+public:
+	/**Constructor for OccupancyPyramid. All counts start at 0
+	\param numOfRows The number of rows in the board
+	\param numOfColumns The number of columns in the board
+	*/
+	OccupancyPyramid(unsigned int numOfRows, unsigned int numOfColumns);
+
+	/**Updates the counts after the occupant of a cell has changed
+	\param row The row of the cell
+	\param column The column of the cell
+	\param oldType The previous occupant of the cell
+	\param newType The new occupant of the cell
+	*/
+	void cellChanged(unsigned int row, unsigned int column, BoardOccupantTypes oldType, BoardOccupantTypes newType);
+
+	/**Recomputes every count from the board buffer. Used after the whole board has been replaced
+	\param cells The board buffer, row after row
+	*/
+	void rebuild(const BoardOccupantTypes* cells);
+
+	/**Counts a species in a rectangle of the board
+	\param cells The board buffer, row after row
+	\param type coyote or roadrunner
+	\param firstRow The first row of the rectangle
+	\param firstColumn The first column of the rectangle
+	\param numOfRectRows The number of rows in the rectangle. Clipped to the board
+	\param numOfRectColumns The number of columns in the rectangle. Clipped to the board
+	\param limit The search stops as soon as the count reaches this value. Used by emptiness checks, which only need to find one agent
+	\return The number of agents of the species in the rectangle, or limit if the count reached it
+	*/
+	unsigned long countInRect(const BoardOccupantTypes* cells, BoardOccupantTypes type, unsigned int firstRow, unsigned int firstColumn,
+		unsigned int numOfRectRows, unsigned int numOfRectColumns, unsigned long limit);
+
+	/**Finds the cell occupied by a species that is nearest to a location, measuring distance in steps up, down, left and right. Tiles are
+	visited nearest first and empty tiles are skipped, so the search only scans the cells of the tiles that are at least as near as the
+	answer
+	\param cells The board buffer, row after row
+	\param type coyote or roadrunner
+	\param row The row of the location
+	\param column The column of the location
+	\return The nearest occupied cell (the location itself if it is occupied by the species), or uninitialized Coordinates if the board
+	holds none of the species
+	*/
+	Coordinates findNearest(const BoardOccupantTypes* cells, BoardOccupantTypes type, unsigned int row, unsigned int column);
+
+	/**Returns the number of levels in the pyramid
+	\return The number of levels
+	*/
+	unsigned int getNumOfLevels();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "OnlineStatistics.h"
+#include <cmath>
+
+OnlineStatistics::OnlineStatistics() {
+	count = 0;
+	mean = 0;
+	sumOfSquaredDeviations = 0;
+}
+
+void OnlineStatistics::add(double value) {
+	count++;
+	double deviation = value - mean;
+	mean += deviation / count;
+	sumOfSquaredDeviations += deviation * (value - mean);
+}
+
+unsigned long OnlineStatistics::getCount() {
+	return count;
+}
+
+double OnlineStatistics::getMean() {
+	return mean;
+}
+
+double OnlineStatistics::getVariance() {
+	return count < 2 ? 0 : sumOfSquaredDeviations / (count - 1);
+}
+
+double OnlineStatistics::meanHalfWidth(double z) {
+	return count == 0 ? INFINITY : z * std::sqrt(getVariance() / count);
+}
+
+double OnlineStatistics::proportionHalfWidth(double z) {
+	if (count == 0) {
+		return INFINITY;
+	}
+	double n = count;
+	return z / (1 + z * z / n) * std::sqrt(mean * (1 - mean) / n + z * z / (4 * n * n));
+}
+
+double OnlineStatistics::proportionCenter(double z) {
+	if (count == 0) {
+		return 0.5;
+	}
+	double n = count;
+	return (mean + z * z / (2 * n)) / (1 + z * z / n);
+}
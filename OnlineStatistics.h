@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ONLINESTATISTICS_H
+#define ONLINESTATISTICS_H
+
+
+/**
+	The mean and variance of a stream of values, updated one value at a time with Welford's method, which stays accurate over long
+	streams without keeping the values
+*/
+class OnlineStatistics {
+private:
+	///The number of values seen
+	unsigned long count;
+	///The mean of the values seen
+	double mean;
+	///The sum of the squared differences of the values from the mean
+	double sumOfSquaredDeviations;
+public:
+	/**Constructor for OnlineStatistics. No values have been seen
+	*/
+	OnlineStatistics();
+
+	/**Adds a value to the stream
+	\param value The value
+	*/
+	void add(double value);
+
+	/**Returns the number of values seen
+	\return The count
+	*/
+	unsigned long getCount();
+
+	/**Returns the mean of the values seen
+	\return The mean, or 0 if no values have been seen
+	*/
+	double getMean();
+
+	/**Returns the sample variance of the values seen
+	\return The variance, or 0 if fewer than two values have been seen
+	*/
+	double getVariance();
+
+	/**Returns the half-width of the normal-approximation confidence interval of the mean
+	\param z The number of standard errors, e.g. 1.96 for 95% confidence
+	\return The half-width
+	*/
+	double meanHalfWidth(double z);
+
+	/**Returns the half-width of the Wilson score confidence interval of a proportion, for a stream of 0/1 values. Unlike the normal
+	approximation, it does not collapse to 0 when every value so far is the same
+	\param z The number of standard errors, e.g. 1.96 for 95% confidence
+	\return The half-width
+	*/
+	double proportionHalfWidth(double z);
+
+	/**Returns the center of the Wilson score confidence interval of a proportion, for a stream of 0/1 values
+	\param z The number of standard errors, e.g. 1.96 for 95% confidence
+	\return The center of the interval
+	*/
+	double proportionCenter(double z);
+};
+
+#endif
@@ -0,0 +1,231 @@
+#include "PreyDistanceField.h"
+#include "TerrainMap.h"
+#include <stdexcept>
+#include <algorithm>
+
+const unsigned short PreyDistanceField::unreachable;
+const unsigned int PreyDistanceField::maxMaxDistance;
+const unsigned int PreyDistanceField::blocked;
+const unsigned int PreyDistanceField::noPrey;
+
+PreyDistanceField::PreyDistanceField(unsigned int numOfRows, unsigned int numOfColumns, unsigned int maxDistance, const Neighborhood &neighborhood) {
+	if (maxDistance == 0 || maxDistance > maxMaxDistance) {
+		throw std::invalid_argument("Invalid pursuit distance");
+	}
+	this->numOfRows = numOfRows;
+	this->numOfColumns = numOfColumns;
+	this->maxDistance = maxDistance;
+	buckets.resize(maxDistance + 1);
+	firstBucket = maxDistance + 1;
+	lastBucket = 0;
+	numOfPrey = 0;
+	terrain = NULL;
+	setNeighborhood(neighborhood);
+}
+
+void PreyDistanceField::setNeighborhood(const Neighborhood &neighborhood) {
+	this->neighborhood = neighborhood;
+	border = neighborhood.getReach();
+	fieldWidth = numOfColumns + 2 * border;
+	unsigned long fieldSize = (numOfRows + 2 * border) * fieldWidth;
+	//cells are stored as 32-bit indices, with two values kept for blocked and noPrey
+	if (fieldSize >= blocked) {
+		throw std::invalid_argument("The board is too large for pursuit");
+	}
+	distance.assign(fieldSize, 0);
+	nearestPrey.assign(fieldSize, blocked);
+}
+
+void PreyDistanceField::setTerrain(const unsigned char* terrain) {
+	this->terrain = terrain;
+}
+
+bool PreyDistanceField::isPrey(const BoardOccupantTypes* cells, unsigned long boardCell) {
+	return cells[boardCell] == BoardOccupantTypes::roadrunner && (terrain == NULL || (terrain[boardCell] & TerrainFlags::cover) == 0);
+}
+
+unsigned long PreyDistanceField::fieldIndex(unsigned int row, unsigned int column) {
+	return (row + border) * fieldWidth + column + border;
+}
+
+void PreyDistanceField::queue(unsigned int cell) {
+	unsigned int cellDistance = distance[cell];
+	buckets[cellDistance].push_back(cell);
+	firstBucket = std::min(firstBucket, cellDistance);
+	lastBucket = std::max(lastBucket, cellDistance);
+}
+
+template <typename Stencil>
+void PreyDistanceField::lowerQueued(const Stencil &stencil) {
+	//the cells are taken in order of distance, so every cell is lowered straight to its final distance. A cell whose distance has been
+	//lowered again since it was queued is also queued under its new distance, and its stale entry is skipped
+	for (unsigned int bucket = firstBucket; bucket <= lastBucket && bucket < maxDistance; bucket++) {
+		std::vector<unsigned int> &cells = buckets[bucket];
+		unsigned short neighborDistance = bucket + 1;
+		for (unsigned long i = 0; i < cells.size(); i++) {
+			unsigned int cell = cells[i];
+			if (distance[cell] != bucket) {
+				continue;
+			}
+			for (unsigned int j = 0; j < stencil.getSize(); j++) {
+				unsigned int neighbor = cell + (long)stencil.getRowOffset(j) * (long)fieldWidth + stencil.getColumnOffset(j);
+				if (distance[neighbor] > neighborDistance) {
+					distance[neighbor] = neighborDistance;
+					nearestPrey[neighbor] = nearestPrey[cell];
+					buckets[neighborDistance].push_back(neighbor);
+				}
+			}
+		}
+		cells.clear();
+		if (!buckets[neighborDistance].empty()) {
+			lastBucket = std::max(lastBucket, (unsigned int)neighborDistance);
+		}
+	}
+	//the cells at the maximum distance have no neighbors to lower
+	for (unsigned int bucket = firstBucket; bucket <= lastBucket; bucket++) {
+		buckets[bucket].clear();
+	}
+	firstBucket = maxDistance + 1;
+	lastBucket = 0;
+}
+
+void PreyDistanceField::lowerQueued() {
+	switch (neighborhood.getType()) {
+	case NeighborhoodTypes::vonNeumann:
+		lowerQueued(VonNeumannStencil());
+		break;
+	case NeighborhoodTypes::moore:
+		lowerQueued(MooreStencil());
+		break;
+	default:
+		lowerQueued(neighborhood);
+	}
+}
+
+template <typename Stencil>
+void PreyDistanceField::raise(const Stencil &stencil, unsigned int cell) {
+	//the cells nearest to the roadrunner form a connected region: every cell in it was lowered by a neighbor nearest to the same
+	//roadrunner, one step closer. The region is cleared, and the cells around it that are nearest to other roadrunners are queued to
+	//lower it again
+	raisedCells.clear();
+	distance[cell] = unreachable;
+	nearestPrey[cell] = noPrey;
+	raisedCells.push_back(cell);
+	for (unsigned long i = 0; i < raisedCells.size(); i++) {
+		for (unsigned int j = 0; j < stencil.getSize(); j++) {
+			unsigned int neighbor = raisedCells[i] + (long)stencil.getRowOffset(j) * (long)fieldWidth + stencil.getColumnOffset(j);
+			unsigned int neighborPrey = nearestPrey[neighbor];
+			if (neighborPrey == cell) {
+				distance[neighbor] = unreachable;
+				nearestPrey[neighbor] = noPrey;
+				raisedCells.push_back(neighbor);
+			} else if (neighborPrey < blocked) {
+				queue(neighbor);
+			}
+		}
+	}
+}
+
+void PreyDistanceField::raise(unsigned int cell) {
+	switch (neighborhood.getType()) {
+	case NeighborhoodTypes::vonNeumann:
+		raise(VonNeumannStencil(), cell);
+		break;
+	case NeighborhoodTypes::moore:
+		raise(MooreStencil(), cell);
+		break;
+	default:
+		raise(neighborhood, cell);
+	}
+}
+
+void PreyDistanceField::cellChanged(unsigned int row, unsigned int column, BoardOccupantTypes oldType, BoardOccupantTypes newType) {
+	if (oldType != newType && (oldType == BoardOccupantTypes::roadrunner || newType == BoardOccupantTypes::roadrunner)) {
+		changedCells.push_back(fieldIndex(row, column));
+	}
+}
+
+void PreyDistanceField::update(const BoardOccupantTypes* cells) {
+	if (changedCells.empty()) {
+		return;
+	}
+	//the cells are taken in the order they are stored in, so that neighboring regions are raised and lowered one after the other
+	std::sort(changedCells.begin(), changedCells.end());
+	changedCells.erase(std::unique(changedCells.begin(), changedCells.end()), changedCells.end());
+	//every roadrunner that moves changes two cells. Once more than about half of them have moved, raising and lowering their regions
+	//costs more than a single search from all of them
+	if (changedCells.size() > numOfPrey) {
+		rebuild(cells);
+		return;
+	}
+	//the roadrunners that have left are removed first, so that the search that lowers the distances again also takes the new
+	//roadrunners into account
+	for (unsigned long i = 0; i < changedCells.size(); i++) {
+		unsigned int cell = changedCells[i];
+		unsigned long boardCell = (cell / fieldWidth - border) * numOfColumns + cell % fieldWidth - border;
+		if (nearestPrey[cell] == cell && !isPrey(cells, boardCell)) {
+			raise(cell);
+			numOfPrey--;
+		}
+	}
+	for (unsigned long i = 0; i < changedCells.size(); i++) {
+		unsigned int cell = changedCells[i];
+		unsigned long boardCell = (cell / fieldWidth - border) * numOfColumns + cell % fieldWidth - border;
+		if (nearestPrey[cell] != cell && isPrey(cells, boardCell)) {
+			distance[cell] = 0;
+			nearestPrey[cell] = cell;
+			queue(cell);
+			numOfPrey++;
+		}
+	}
+	changedCells.clear();
+	lowerQueued();
+}
+
+void PreyDistanceField::rebuild(const BoardOccupantTypes* cells) {
+	changedCells.clear();
+	numOfPrey = 0;
+	//a breadth-first search from all the roadrunners at once. The border stays blocked
+	for (unsigned int row = 0; row < numOfRows; row++) {
+		for (unsigned int column = 0; column < numOfColumns; column++) {
+			unsigned long cell = fieldIndex(row, column);
+			unsigned long boardCell = (unsigned long)row * numOfColumns + column;
+			if (terrain != NULL && (terrain[boardCell] & TerrainFlags::wall) != 0) {
+				distance[cell] = 0;
+				nearestPrey[cell] = blocked;
+			} else if (isPrey(cells, boardCell)) {
+				distance[cell] = 0;
+				nearestPrey[cell] = cell;
+				queue(cell);
+				numOfPrey++;
+			} else {
+				distance[cell] = unreachable;
+				nearestPrey[cell] = noPrey;
+			}
+		}
+	}
+	lowerQueued();
+}
+
+unsigned int PreyDistanceField::getDistance(unsigned int row, unsigned int column) {
+	return distance[fieldIndex(row, column)];
+}
+
+unsigned long long PreyDistanceField::closerNeighbors(unsigned int row, unsigned int column) {
+	unsigned long cell = fieldIndex(row, column);
+	unsigned int cellDistance = distance[cell];
+	if (cellDistance == unreachable || cellDistance == 0) {
+		return 0;
+	}
+	unsigned long long mask = 0;
+	for (unsigned int i = 0; i < neighborhood.getSize(); i++) {
+		unsigned int neighborDistance = distance[cell + (long)neighborhood.getRowOffset(i) * (long)fieldWidth + neighborhood.getColumnOffset(i)];
+		//the roadrunners, the blocked border and the walls are at distance 0, and wrap around to the largest value here
+		mask |= (unsigned long long)(neighborDistance - 1 < cellDistance - 1) << i;
+	}
+	return mask;
+}
+
+unsigned int PreyDistanceField::getMaxDistance() {
+	return maxDistance;
+}
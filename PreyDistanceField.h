@@ -0,0 +1,169 @@
+#pragma once
+#ifndef PREYDISTANCEFIELD_H
+#define PREYDISTANCEFIELD_H
+
+#include "SimulationBoard.h"
+#include "Neighborhood.h"
+#include <vector>
+
+
+/**
+	The distance from every cell of the board to the nearest roadrunner, counted in steps through the neighborhood of the board and
+	capped at a maximum distance. Coyotes in pursuit mode walk down this field towards their prey.
+
+	The field is repaired rather than recomputed. Every cell remembers which roadrunner it is nearest to, and the board reports the cells
+	that roadrunners enter or leave. When the field is brought up to date, the cells that were nearest to a roadrunner that has left are
+	raised (they form a connected region around it), and a single breadth-first search then lowers the distances outwards from the new
+	roadrunners and from the cells bordering the raised regions, stopping wherever a cell is already at least as close to another
+	roadrunner. Only the cells whose distance changes and their neighbors are touched, and a cell that a roadrunner leaves and another
+	enters before the next update costs nothing. When most of the roadrunners have moved since the last update, the raised regions cover
+	about as much of the board as the whole field, and the field is recomputed instead, which touches every cell only once.
+
+	The field is surrounded by a border of blocked cells as wide as the reach of the neighborhood, so the searches never check whether a
+	neighbor lies inside the board. Walls are blocked cells too, and roadrunners in cover are not in sight. Rows are indices into the board buffer; SimulationBoard converts global rows before calling in.
+*/
+class PreyDistanceField {
+public:
+	///The distance of the cells that are farther than the maximum distance from every roadrunner
+	static const unsigned short unreachable = 0xffff;
+	///The largest maximum distance
+	static const unsigned int maxMaxDistance = unreachable - 1;
+private:
+	///The value of nearestPrey for the blocked cells around the board and on walls. Their distance is 0, so that no search lowers them
+	static const unsigned int blocked = 0xfffffffe;
+	///The value of nearestPrey for the cells that are farther than the maximum distance from every roadrunner
+	static const unsigned int noPrey = 0xffffffff;
+
+	///The number of rows in the board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The width of the blocked border around the board: the reach of the neighborhood
+	unsigned int border;
+	///The number of columns in the field, including the border on both sides
+	unsigned long fieldWidth;
+	///The distance beyond which roadrunners are out of sight
+	unsigned int maxDistance;
+	///The neighborhood the distances are counted in
+	Neighborhood neighborhood;
+	///The distance from every cell of the field to the nearest roadrunner, in row-major order
+	std::vector<unsigned short> distance;
+	///The field index of the roadrunner each cell is nearest to, noPrey, or blocked
+	std::vector<unsigned int> nearestPrey;
+	///The cells waiting to lower the distances of their neighbors, by distance (a bucket queue). Kept between calls to reuse the memory
+	std::vector<std::vector<unsigned int> > buckets;
+	///The lowest distance with cells waiting in buckets
+	unsigned int firstBucket;
+	///The highest distance with cells waiting in buckets
+	unsigned int lastBucket;
+	///The cells raised by the last roadrunner that left the board. Kept between calls to reuse the memory
+	std::vector<unsigned int> raisedCells;
+	///The cells that roadrunners have entered or left since the last update, possibly more than once each
+	std::vector<unsigned int> changedCells;
+	///The number of roadrunners in sight as of the last update
+	unsigned long numOfPrey;
+	///The TerrainFlags of every cell of the board, or NULL if the board has no terrain
+	const unsigned char* terrain;
+
+	/**Checks if a cell of the board holds a roadrunner that is in sight
+	\param cells The board buffer, in row-major order
+	\param boardCell The index of the cell in the board buffer
+	\return True if the cell holds a roadrunner that is not in cover
+	*/
+	bool isPrey(const BoardOccupantTypes* cells, unsigned long boardCell);
+
+	/**Returns the index in the field of a cell of the board
+	\param row The row of the cell in the board buffer
+	\param column The column of the cell
+	\return The index of the cell in distance and nearestPrey
+	*/
+	unsigned long fieldIndex(unsigned int row, unsigned int column);
+
+	/**Queues a cell to lower the distances of its neighbors
+	\param cell The index of the cell in the field
+	*/
+	void queue(unsigned int cell);
+
+	/**Lowers the distances outwards from the queued cells, in order of distance, until no distance changes. Instantiated with
+	VonNeumannStencil and MooreStencil so that the loops over the neighbors are unrolled, and with the Neighborhood for the others
+	\param stencil The neighbors of a cell
+	*/
+	template <typename Stencil>
+	void lowerQueued(const Stencil &stencil);
+
+	/**Raises the cells nearest to a roadrunner that has left the board and queues the cells around them. Instantiated like lowerQueued()
+	\param stencil The neighbors of a cell
+	\param cell The index in the field of the cell the roadrunner has left
+	*/
+	template <typename Stencil>
+	void raise(const Stencil &stencil, unsigned int cell);
+
+	/**Calls lowerQueued() with the stencil of the neighborhood
+	*/
+	void lowerQueued();
+
+	/**Calls raise() with the stencil of the neighborhood
+	\param cell The index in the field of the cell the roadrunner has left
+	*/
+	void raise(unsigned int cell);
+public:
+	/**Constructor for PreyDistanceField. The field starts without roadrunners. Throws an invalid_argument exception if the maximum
+	distance is 0 or larger than maxMaxDistance, or if the board has too many cells
+	\param numOfRows The number of rows in the board
+	\param numOfColumns The number of columns in the board
+	\param maxDistance The distance beyond which roadrunners are out of sight
+	\param neighborhood The neighborhood the distances are counted in
+	*/
+	PreyDistanceField(unsigned int numOfRows, unsigned int numOfColumns, unsigned int maxDistance, const Neighborhood &neighborhood);
+
+	/**Changes the neighborhood the distances are counted in. The field must be rebuilt afterwards
+	\param neighborhood The new neighborhood
+	*/
+	void setNeighborhood(const Neighborhood &neighborhood);
+
+	/**Sets the terrain of the board. The field must be rebuilt afterwards
+	\param terrain The TerrainFlags of every cell of the board, in row-major order, or NULL for open ground everywhere. Must stay valid as
+	long as the field is used
+	*/
+	void setTerrain(const unsigned char* terrain);
+
+	/**Records a change to a cell of the board, to be taken into account by the next update()
+	\param row The row of the cell in the board buffer
+	\param column The column of the cell
+	\param oldType The previous occupant of the cell
+	\param newType The new occupant of the cell
+	*/
+	void cellChanged(unsigned int row, unsigned int column, BoardOccupantTypes oldType, BoardOccupantTypes newType);
+
+	/**Recomputes the field from scratch
+	\param cells The board buffer, in row-major order
+	*/
+	void rebuild(const BoardOccupantTypes* cells);
+
+	/**Brings the field up to date with the changes recorded since the last update or rebuild
+	\param cells The board buffer, in row-major order
+	*/
+	void update(const BoardOccupantTypes* cells);
+
+	/**Returns the distance from a cell to the nearest roadrunner, as of the last update
+	\param row The row of the cell in the board buffer
+	\param column The column of the cell
+	\return The distance, or unreachable if every roadrunner is farther than the maximum distance
+	*/
+	unsigned int getDistance(unsigned int row, unsigned int column);
+
+	/**Finds the neighbors of a cell that are closer to the nearest roadrunner than the cell itself, as of the last update, not counting
+	the cells that held roadrunners or lie outside the board
+	\param row The row of the cell in the board buffer
+	\param column The column of the cell
+	\return A neighbor mask with bit i set if neighbor i of the neighborhood is closer. 0 if no roadrunner is in sight
+	*/
+	unsigned long long closerNeighbors(unsigned int row, unsigned int column);
+
+	/**Returns the distance beyond which roadrunners are out of sight
+	\return The maximum distance
+	*/
+	unsigned int getMaxDistance();
+};
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef RANDOMSAMPLING_H
+#define RANDOMSAMPLING_H
+
+#include <stdlib.h>
+#include <unordered_map>
+
+
+/**
+	Returns a random value drawn with rand(), for bounds that may be larger than RAND_MAX
+	\param bound The number of values to choose from. Must be positive
+	\return A value in [0, bound)
+*/
+inline unsigned long randomIndex(unsigned long bound) {
+	if (bound <= (unsigned long)RAND_MAX) {
+		return rand() % bound;
+	}
+	return ((unsigned long)rand() * ((unsigned long)RAND_MAX + 1) + rand()) % bound;
+}
+
+/**
+	Draws distinct values out of [0, numOfValues) uniformly at random with a partial Fisher-Yates shuffle: the first numOfDraws entries
+	of a random permutation of the values are drawn in numOfDraws steps, so every draw takes one call to randomIndex(), however few values
+	are left. Only the entries of the permutation that have been swapped away from their own index are stored, so the memory used grows
+	with the number of draws rather than with the number of values
+	\param numOfValues The number of values to draw from
+	\param numOfDraws The number of values to draw. Must not exceed numOfValues
+	\param visit Called with the index of each draw (0 for the first) and the value drawn
+*/
+template <typename Visitor>
+void drawDistinct(unsigned long numOfValues, unsigned long numOfDraws, Visitor visit) {
+	std::unordered_map<unsigned long, unsigned long> swappedValues;
+	swappedValues.reserve(numOfDraws);
+	for (unsigned long i = 0; i < numOfDraws; i++) {
+		unsigned long j = i + randomIndex(numOfValues - i);
+		std::unordered_map<unsigned long, unsigned long>::iterator entryJ = swappedValues.find(j);
+		unsigned long value = entryJ == swappedValues.end() ? j : entryJ->second;
+		std::unordered_map<unsigned long, unsigned long>::iterator entryI = swappedValues.find(i);
+		//entry i is never looked at again, so only entry j needs to take its old value
+		swappedValues[j] = entryI == swappedValues.end() ? i : entryI->second;
+		visit(i, value);
+	}
+}
+
+#endif
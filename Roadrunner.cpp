@@ -4,47 +4,27 @@ Roadrunner::Roadrunner(SimulationBoard* board, Coordinates location) : Agent(boa
 
 }
 
-int Roadrunner::numOfAdjacentCoyotes(Coordinates inLocation) {
-	int counter = 0;
-	Coordinates tempLocation;
-
-	//look to see there is a coyote below
-	tempLocation.setCoordinates(inLocation.getRow() + 1, inLocation.getColumn());
-	if (board->existsHere(BoardOccupantTypes::coyote, tempLocation)) {
-		counter++;
-	}
-
-	//look to see there is a coyote above
-	tempLocation.setCoordinates(inLocation.getRow() - 1, inLocation.getColumn());
-	if (board->existsHere(BoardOccupantTypes::coyote, tempLocation)) {
-		counter++;
-	}
+Roadrunner::Roadrunner(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, bool addToBoard) : Agent(board, location, breedCountdown, BoardOccupantTypes::roadrunner, addToBoard) {
 
-	//look to see there is a coyote to the right
-	tempLocation.setCoordinates(inLocation.getRow(), inLocation.getColumn() + 1);
-	if (board->existsHere(BoardOccupantTypes::coyote, tempLocation)) {
-		counter++;
-	}
+}
 
-	//look to see there is a coyote to the left
-	tempLocation.setCoordinates(inLocation.getRow(), inLocation.getColumn() - 1);
-	if (board->existsHere(BoardOccupantTypes::coyote, tempLocation)) {
-		counter++;
-	}
-	return counter;
+int Roadrunner::numOfAdjacentCoyotes(Coordinates inLocation) {
+	//look to see which neighbors hold coyotes all at once, and count them
+	return __builtin_popcountll(board->neighborMask(inLocation, BoardOccupantTypes::coyote));
 }
 
-void Roadrunner::move() {
-	Coordinates newLocation;
+Coordinates Roadrunner::chooseMove() {
 	//if no adjacent coyotes in the current location, then just move in a random unoccupied adjacent location
 	if (numOfAdjacentCoyotes(location) == 0) {
-		newLocation = findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
-	} else {
-		//else, look for a location (within 1 or 2 steps) with the least number of adjacent coyotes
-		unsigned int numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(location);
-		newLocation = moveImplementation(location, numOfCoyoteesInNewLocation, 2);
+		return findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
 	}
+	//else, look for a location (within 1 or 2 steps) with the least number of adjacent coyotes
+	unsigned int numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(location);
+	return moveImplementation(location, numOfCoyoteesInNewLocation, maxStepsPerMove);
+}
 
+void Roadrunner::move() {
+	Coordinates newLocation = chooseMove();
 	if (newLocation.initialized()) {
 		board->moveAgent(location, newLocation);
 		location = newLocation;
@@ -59,65 +39,25 @@ Coordinates Roadrunner::moveImplementation(Coordinates currLocation, unsigned in
 		return currLocation;
 	}
 	Coordinates foundLocation;
-	//this vector lists the directions the roadrunner can move.
-	//if one direction is not viable, then that direction is removed from the vector and the other directions are checked
-	std::vector<char> locationToMoveTo = { 'u', 'd', 'l', 'r' };
-	int index;
-	while (locationToMoveTo.size() > 0) { //loop until all locations are checked (unless an ideal location is found before that)
-		index = rand() % locationToMoveTo.size();
-		switch (locationToMoveTo[index]) {
-		case 'u':
-
-			foundLocation.setCoordinates(currLocation.getRow() - 1, currLocation.getColumn());
-			//check if up is a viable location (it is unoccupied)
-			if (board->existsHere(BoardOccupantTypes::unoccupied, foundLocation)) {
-				//if the number of coyotes adjacent to the up location is less than the number of coyotees in our current new location,
-				//then set our current new location to up
-				if (numOfCoyoteesInNewLocation > numOfAdjacentCoyotes(foundLocation)) {
-					numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(foundLocation);
-					currLocation = foundLocation;
-				}
-				//now, repeat the process, but with up as the new reference location
-				//this is the recursive part where the logic of the roadrunner being able to take 2 steps comes into play
-				currLocation = moveImplementation(currLocation, numOfCoyoteesInNewLocation, stepsAllowed - 1);
+	//this mask lists the directions the roadrunner has not checked yet (bit 0 = up, 1 = down, 2 = left, 3 = right, then the other
+	//neighbors of the neighborhood). Each direction is picked at random and removed from the mask, whether it is viable or not
+	unsigned long long directionsToCheck = board->getNeighborhood().getAllNeighbors();
+	int direction;
+	while (directionsToCheck != 0) { //loop until all locations are checked (unless an ideal location is found before that)
+		direction = randomDirection(directionsToCheck);
+		directionsToCheck &= ~(1ULL << direction);
+		foundLocation = stepInDirection(currLocation, direction);
+		//check if the location in this direction is a viable location (it is unoccupied)
+		if (board->existsHere(BoardOccupantTypes::unoccupied, foundLocation, type)) {
+			//if the number of coyotes adjacent to the location is less than the number of coyotees in our current new location,
+			//then set our current new location to it
+			if (numOfCoyoteesInNewLocation > numOfAdjacentCoyotes(foundLocation)) {
+				numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(foundLocation);
+				currLocation = foundLocation;
 			}
-			//since this location has been checked already, remove it from the vector
-			locationToMoveTo.erase(locationToMoveTo.begin() + index);
-			break;
-			//repeat the same process for the other three directions as well
-		case 'd':
-			foundLocation.setCoordinates(currLocation.getRow() + 1, currLocation.getColumn());
-			if (board->existsHere(BoardOccupantTypes::unoccupied, foundLocation)) {
-				if (numOfCoyoteesInNewLocation > numOfAdjacentCoyotes(foundLocation)) {
-					numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(foundLocation);
-					currLocation = foundLocation;
-				}
-				currLocation = moveImplementation(currLocation, numOfCoyoteesInNewLocation, stepsAllowed - 1);
-			}
-			locationToMoveTo.erase(locationToMoveTo.begin() + index);
-			break;
-		case 'l':
-			foundLocation.setCoordinates(currLocation.getRow(), currLocation.getColumn() - 1);
-			if (board->existsHere(BoardOccupantTypes::unoccupied, foundLocation)) {
-				if (numOfCoyoteesInNewLocation > numOfAdjacentCoyotes(foundLocation)) {
-					numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(foundLocation);
-					currLocation = foundLocation;
-				}
-				currLocation = moveImplementation(currLocation, numOfCoyoteesInNewLocation, stepsAllowed - 1);
-			}
-			locationToMoveTo.erase(locationToMoveTo.begin() + index);
-			break;
-		case 'r':
-			foundLocation.setCoordinates(currLocation.getRow(), currLocation.getColumn() + 1);
-			if (board->existsHere(BoardOccupantTypes::unoccupied, foundLocation)) {
-				if (numOfCoyoteesInNewLocation > numOfAdjacentCoyotes(foundLocation)) {
-					numOfCoyoteesInNewLocation = numOfAdjacentCoyotes(foundLocation);
-					currLocation = foundLocation;
-				}
-				currLocation = moveImplementation(currLocation, numOfCoyoteesInNewLocation, stepsAllowed - 1);
-			}
-			locationToMoveTo.erase(locationToMoveTo.begin() + index);
-			break;
+			//now, repeat the process, but with the new location as the reference location
+			//this is the recursive part where the logic of the roadrunner being able to take 2 steps comes into play
+			currLocation = moveImplementation(currLocation, numOfCoyoteesInNewLocation, stepsAllowed - 1);
 		}
 		//if for  any new location, the number of adjacent coyotes is 0, then return that location
 		if (numOfAdjacentCoyotes(currLocation) == 0) {
@@ -168,3 +108,33 @@ Agent* Roadrunner::breed() {
 	}
 	return babyRoadrunner;
 }
+
+
+void Roadrunner::planStep(AgentIntent &intent) {
+	randomStream = &intent.randomState;
+	intent.moveTo = chooseMove();
+	//the roadrunner breeds this step if its countdown is about to reach 0. The baby is placed next to the roadrunner's previous location
+	if (breedCountdown <= 1) {
+		intent.birthAt = findRandomViableLocation(location, BoardOccupantTypes::unoccupied);
+	}
+	randomStream = NULL;
+}
+
+Agent* Roadrunner::commitStep(const AgentIntent &intent) {
+	if (intent.eaten) {
+		alive = false;
+		return NULL;
+	}
+	if (intent.moveGranted) {
+		location = intent.moveTo;
+	}
+	if (breedCountdown > 0) {
+		breedCountdown--;
+	}
+	Agent* babyRoadrunner = NULL;
+	if (breedCountdown == 0 && intent.birthGranted) {
+		breedCountdown = 3;
+		babyRoadrunner = new Roadrunner(board, intent.birthAt, 3, false);
+	}
+	return babyRoadrunner;
+}
@@ -23,6 +23,12 @@ private:
 	*/
 	void move();
 
+	/**
+		Implementation function shared by move() and planStep(). Chooses the location the roadrunner will move to without modifying the board.
+		\return The chosen location. Uninitialized if the roadrunner cannot move
+	*/
+	Coordinates chooseMove();
+
 	/**
 		This is an implementation function utilized by the move() function. It is called when there is a Coyote adjacent to this
 		roadrunner object. This function returns a new location with the least adjacent number of coyotes. This location may be 1 or 2
@@ -40,16 +46,36 @@ private:
 	*/
 	Agent* breed();
 public:
+	///The number of steps a roadrunner can take in one move, away from the coyotes next to it
+	static const unsigned int maxStepsPerMove = 2;
+
 	/**
 		The constructor for the Roadrunner class
 		\param board The board on which this roadrunner object will reside
 		\param location The location in which this roadrunner object will reside
 	*/
 	Roadrunner(SimulationBoard* board, Coordinates location);
+	/**
+		The constructor used to recreate a roadrunner from a copy of its state
+		\param board The board on which this roadrunner object will reside
+		\param location The location in which this roadrunner object will reside
+		\param breedCountdown The number of turns left until the roadrunner breeds
+		\param addToBoard False if the caller writes the roadrunner into the board itself
+	*/
+	Roadrunner(SimulationBoard* board, Coordinates location, unsigned int breedCountdown, bool addToBoard = true);
 	/** Executes the actions that the roadrunner object will make in its given turn. This action includes move, breed, and die.
 		\return If the roadrunner object breeds and creates a child object, then it returns a pointer to the child object. Else, it returns NULL
 	*/
 	Agent* act();
+	/**Computes the roadrunner's intended move and birth against the previous-step board
+		\param intent The intent to fill in
+	*/
+	void planStep(AgentIntent &intent);
+	/**Applies the resolved intent: dies if eaten, otherwise moves and breeds without touching the board
+		\param intent The resolved intent
+		\return If the roadrunner breeds, a pointer to the baby roadrunner, which is not on the board yet. Else, NULL
+	*/
+	Agent* commitStep(const AgentIntent &intent);
 };
 
 #endif
@@ -0,0 +1,319 @@
+#include "ShardedSimulation.h"
+#include "Coyote.h"
+#include "Roadrunner.h"
+#include "RandomSampling.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+const unsigned int ShardedSimulation::haloRows;
+
+/**returns a random value to use in std::random_shuffle()
+*/
+static int shardRandom(int i) {
+	return std::rand() % i;
+}
+
+/**Appends the raw bytes of a value to a message
+\param message The message to append to
+\param value The value to append
+*/
+template <typename T>
+static void appendValue(std::vector<char> &message, const T &value) {
+	const char* bytes = (const char*)&value;
+	message.insert(message.end(), bytes, bytes + sizeof(T));
+}
+
+/**Reads a value from a message and advances the read position past it
+\param message The message to read from
+\param position The read position
+\return The value read
+*/
+template <typename T>
+static T readValue(const std::vector<char> &message, unsigned long &position) {
+	T value;
+	memcpy(&value, message.data() + position, sizeof(T));
+	position += sizeof(T);
+	return value;
+}
+
+ShardedSimulation::ShardedSimulation(Communicator* communicator, unsigned int numOfRows, unsigned int numOfColumns, unsigned int initialNumOfRoadrunners,
+	unsigned int initialNumOfCoyotes, unsigned int seed, BoardRenderer* renderer, unsigned int numOfGhostRows) {
+	this->communicator = communicator;
+	this->numOfRows = numOfRows;
+	this->numOfColumns = numOfColumns;
+	this->renderer = renderer;
+	this->numOfGhostRows = std::max(numOfGhostRows, haloRows);
+	stopCondition = NULL;
+	runningUntilCondition = false;
+	firstOwnedRow = firstRowOf(communicator->rank());
+	endOwnedRow = firstRowOf(communicator->rank() + 1);
+	unsigned int firstStoredRow = firstOwnedRow >= this->numOfGhostRows ? firstOwnedRow - this->numOfGhostRows : 0;
+	unsigned int endStoredRow = (unsigned int)std::min((unsigned long)endOwnedRow + this->numOfGhostRows, (unsigned long)numOfRows);
+	board = SimulationBoard::createStrip(firstStoredRow, endStoredRow - firstStoredRow, numOfColumns);
+
+	//each strip draws from its own random sequence, from the placement of its agents on
+	srand(seed + communicator->rank() + 1);
+	placeAgentsRandomly(initialNumOfRoadrunners, initialNumOfCoyotes);
+	exchangeWithNeighbors();
+}
+
+ShardedSimulation::~ShardedSimulation() {
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		delete agentList[i];
+	}
+	for (unsigned int i = 0; i < arrivedAgents.size(); i++) {
+		delete arrivedAgents[i];
+	}
+	delete stopCondition;
+	delete board;
+}
+
+/**Returns the share of a total that falls before a point, when the total is spread evenly over a range
+\param total The total to spread
+\param point The point, between 0 and whole
+\param whole The size of the range. Must be positive
+\return total * point / whole, rounded down, without overflowing for totals and ranges that fit in 32 bits
+*/
+static unsigned long shareBefore(unsigned long total, unsigned long point, unsigned long whole) {
+	return total / whole * point + total % whole * point / whole;
+}
+
+void ShardedSimulation::placeAgentsRandomly(unsigned int initialNumOfRoadrunners, unsigned int initialNumOfCoyotes) {
+	//the agents of the whole board are numbered, and each strip takes the numbers that fall into its rows. The roadrunners are spread
+	//evenly over the numbers, so every strip gets its share of each species, and the shares add up to the totals
+	unsigned long numOfAgents = (unsigned long)initialNumOfRoadrunners + initialNumOfCoyotes;
+	unsigned long firstAgent = shareBefore(numOfAgents, firstOwnedRow, numOfRows);
+	unsigned long endAgent = shareBefore(numOfAgents, endOwnedRow, numOfRows);
+	unsigned long numOfRoadrunners = shareBefore(initialNumOfRoadrunners, endAgent, numOfAgents) - shareBefore(initialNumOfRoadrunners, firstAgent, numOfAgents);
+	//the agents land on distinct cells of the strip's own rows, with one draw each however full the strip is
+	unsigned long firstCell = (unsigned long)firstOwnedRow * numOfColumns;
+	drawDistinct((unsigned long)(endOwnedRow - firstOwnedRow) * numOfColumns, endAgent - firstAgent, [&](unsigned long i, unsigned long cell) {
+		Coordinates location((firstCell + cell) / numOfColumns, (firstCell + cell) % numOfColumns);
+		if (i < numOfRoadrunners) {
+			agentList.push_back(new Roadrunner(board, location));
+		} else {
+			agentList.push_back(new Coyote(board, location));
+		}
+	});
+}
+
+unsigned int ShardedSimulation::firstRowOf(int processRank) {
+	return (unsigned long)processRank * numOfRows / communicator->size();
+}
+
+void ShardedSimulation::actAll() {
+	Agent* temp = NULL;
+	std::random_shuffle(agentList.begin(), agentList.end(), shardRandom);
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		temp = agentList[i]->act();
+		if (temp != NULL) {
+			agentList.push_back(temp);
+			std::random_shuffle(agentList.begin() + i + 1, agentList.end(), shardRandom);
+		}
+	}
+}
+
+std::vector<char> ShardedSimulation::packForNeighbor(int neighbor) {
+	std::vector<char> message;
+	bool above = neighbor < communicator->rank();
+
+	//the rows of this strip that the neighbor stores as ghost rows
+	unsigned int firstRow = above ? firstOwnedRow : endOwnedRow - std::min(numOfGhostRows, endOwnedRow - firstOwnedRow);
+	unsigned int endRow = above ? firstOwnedRow + std::min(numOfGhostRows, endOwnedRow - firstOwnedRow) : endOwnedRow;
+	appendValue(message, endRow - firstRow);
+	for (unsigned int row = firstRow; row < endRow; row++) {
+		std::vector<BoardOccupantTypes> contents = board->copyRow(row);
+		message.insert(message.end(), (const char*)contents.data(), (const char*)(contents.data() + contents.size()));
+	}
+
+	//the agents that moved or were born into the neighbor's rows. Agents that died there (starved coyotes, or roadrunners that were
+	//eaten after moving) are dropped
+	std::vector<AgentState> migrants;
+	std::vector<Agent*> remainingAgents;
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		Coordinates agentLocation = agentList[i]->getLocation();
+		bool inNeighborRows = above ? agentLocation.getRow() < firstOwnedRow : agentLocation.getRow() >= endOwnedRow;
+		if (!inNeighborRows) {
+			remainingAgents.push_back(agentList[i]);
+			continue;
+		}
+		if (agentList[i]->isAlive() && board->existsHere(agentList[i]->getType(), agentLocation)) {
+			migrants.push_back(agentList[i]->getState());
+		}
+		delete agentList[i];
+	}
+	agentList = remainingAgents;
+	appendValue(message, (unsigned int)migrants.size());
+	for (unsigned int i = 0; i < migrants.size(); i++) {
+		appendValue(message, migrants[i]);
+	}
+	return message;
+}
+
+void ShardedSimulation::unpackFromNeighbor(int neighbor, const std::vector<char> &message) {
+	bool above = neighbor < communicator->rank();
+	unsigned long position = 0;
+
+	//refresh the ghost rows
+	unsigned int numOfGhostRows = readValue<unsigned int>(message, position);
+	unsigned int firstRow = above ? firstOwnedRow - numOfGhostRows : endOwnedRow;
+	std::vector<BoardOccupantTypes> contents(numOfColumns);
+	for (unsigned int row = firstRow; row < firstRow + numOfGhostRows; row++) {
+		memcpy(contents.data(), message.data() + position, numOfColumns * sizeof(BoardOccupantTypes));
+		position += numOfColumns * sizeof(BoardOccupantTypes);
+		board->overwriteRow(row, contents);
+	}
+
+	//recreate the agents that migrated into this strip. A migrating coyote may land on a roadrunner, which it has eaten
+	unsigned int numOfMigrants = readValue<unsigned int>(message, position);
+	for (unsigned int i = 0; i < numOfMigrants; i++) {
+		arrivedAgents.push_back(Agent::fromState(board, readValue<AgentState>(message, position)));
+	}
+}
+
+void ShardedSimulation::exchangeWithNeighbors() {
+	int rank = communicator->rank();
+	std::vector<char> toAbove, toBelow;
+	if (rank > 0) {
+		toAbove = packForNeighbor(rank - 1);
+	}
+	if (rank < communicator->size() - 1) {
+		toBelow = packForNeighbor(rank + 1);
+	}
+	if (rank > 0) {
+		unpackFromNeighbor(rank - 1, communicator->exchange(rank - 1, toAbove));
+	}
+	if (rank < communicator->size() - 1) {
+		unpackFromNeighbor(rank + 1, communicator->exchange(rank + 1, toBelow));
+	}
+}
+
+void ShardedSimulation::step() {
+	//even strips act first, then odd strips, so that neighboring strips never act at the same time
+	for (int phase = 0; phase < 2; phase++) {
+		if (communicator->rank() % 2 == phase) {
+			actAll();
+		}
+		exchangeWithNeighbors();
+	}
+
+	//the migrants join the strip's agents, and the dead agents are deallocated
+	agentList.insert(agentList.end(), arrivedAgents.begin(), arrivedAgents.end());
+	arrivedAgents.clear();
+	std::vector<Agent*> aliveAgents;
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		if (agentList[i]->isAlive()) {
+			aliveAgents.push_back(agentList[i]);
+		} else {
+			delete agentList[i];
+		}
+	}
+	agentList = aliveAgents;
+}
+
+std::vector<unsigned long> ShardedSimulation::totals() {
+	std::vector<unsigned long> values(3, 0);
+	values[0] = agentList.size();
+	for (unsigned int row = firstOwnedRow; row < endOwnedRow; row++) {
+		std::vector<BoardOccupantTypes> contents = board->copyRow(row);
+		values[1] += std::count(contents.begin(), contents.end(), BoardOccupantTypes::roadrunner);
+		values[2] += std::count(contents.begin(), contents.end(), BoardOccupantTypes::coyote);
+	}
+	communicator->sumOverProcesses(values);
+	return values;
+}
+
+void ShardedSimulation::printBoard() {
+	std::vector<unsigned long> counts = renderer->countWindow(board, numOfRows, firstOwnedRow, endOwnedRow);
+	communicator->sumOverProcesses(counts);
+	if (communicator->rank() == 0) {
+		renderer->printCounts(numOfRows, numOfColumns, counts);
+	}
+}
+
+unsigned long long ShardedSimulation::hashBoard() {
+	std::vector<char> message;
+	appendValue(message, board->hashRows(firstOwnedRow, endOwnedRow - firstOwnedRow));
+	std::vector<std::vector<char>> hashes = communicator->gather(message, 0);
+	unsigned long long hash = 0;
+	for (unsigned int i = 0; i < hashes.size(); i++) {
+		unsigned long position = 0;
+		hash ^= readValue<unsigned long long>(hashes[i], position);
+	}
+	return hash;
+}
+
+int ShardedSimulation::readChoice(int (*menuLogic)(char), void (*printOptions)(), StopCondition* (*readStopCondition)(unsigned long, unsigned long)) {
+	std::vector<unsigned long> counts = totals();
+	int choice = 0;
+	delete stopCondition;
+	stopCondition = NULL;
+	if (communicator->rank() == 0) {
+		char prompt;
+		printOptions();
+		std::cin >> prompt;
+		choice = menuLogic(prompt);
+		if (prompt == '8') {
+			stopCondition = readStopCondition(counts[2], counts[1]);
+			if (stopCondition == NULL) {
+				choice = -2;
+			}
+		}
+	}
+	std::vector<char> message;
+	appendValue(message, choice);
+	appendValue(message, stopCondition != NULL);
+	communicator->broadcast(message, 0);
+	unsigned long position = 0;
+	choice = readValue<int>(message, position);
+	runningUntilCondition = readValue<bool>(message, position);
+	return choice;
+}
+
+bool ShardedSimulation::stopConditionMet() {
+	std::vector<unsigned long> counts = totals();
+	std::vector<char> message;
+	if (communicator->rank() == 0) {
+		//shards have no terrain, so every cell of the board can be occupied
+		bool met = stopCondition->isMet(counts[2], counts[1], (unsigned long)numOfRows * numOfColumns);
+		appendValue(message, met);
+		if (met) {
+			std::cout << "Stopped because " << stopCondition->describe() << "." << std::endl;
+		}
+	}
+	communicator->broadcast(message, 0);
+	unsigned long position = 0;
+	return readValue<bool>(message, position);
+}
+
+void ShardedSimulation::run(int (*menuLogic)(char), void (*printOptions)(), StopCondition* (*readStopCondition)(unsigned long, unsigned long)) {
+	if (communicator->rank() == 0) {
+		std::cout << "Initial state of board: " << std::endl;
+	}
+	printBoard();
+	int timeStepsCountdown = readChoice(menuLogic, printOptions, readStopCondition);
+
+	//Run until no agents left or until only roadrunners left. The board is printed at most once per time step, since the agents of
+	//different strips do not act one after the other
+	while (true) {
+		std::vector<unsigned long> counts = totals();
+		if (counts[0] == 0 || counts[1] >= (unsigned long)numOfRows * numOfColumns) {
+			break;
+		}
+		timeStepsCountdown--;
+		step();
+		bool showBoard = runningUntilCondition ? stopConditionMet() : (timeStepsCountdown == 0 || timeStepsCountdown == -1);
+		if (showBoard) {
+			printBoard();
+			timeStepsCountdown = readChoice(menuLogic, printOptions, readStopCondition);
+		}
+		if (timeStepsCountdown < -1) {
+			break;
+		}
+	}
+	printBoard();
+	if (communicator->rank() == 0) {
+		std::cout << std::endl << "End of simulation." << std::endl << std::endl;
+	}
+}
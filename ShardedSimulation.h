@@ -0,0 +1,152 @@
+#pragma once
+#ifndef SHARDEDSIMULATION_H
+#define SHARDEDSIMULATION_H
+
+#include "Agent.h"
+#include "Roadrunner.h"
+#include "Communicator.h"
+#include "StopCondition.h"
+#include "BoardRenderer.h"
+#include <vector>
+
+
+/**
+	Runs the simulation on a board that is split into horizontal strips, each owned by a separate process. Every process stores its own
+	rows plus haloRows ghost rows on each side in a strip SimulationBoard and runs the normal act() loop on the agents in its rows. Each
+	strip places its own share of the initial agents, so no process ever holds the whole board.
+
+	Neighboring strips never act at the same time: in the first half of a time step the even ranks act, in the second half the odd ranks
+	do. After each half, neighbors exchange their boundary rows (which become the other side's ghost rows) and the agents that moved or
+	were born into the other side's rows. Since a strip only ever acts with fresh ghost rows, agents on both sides of a boundary see the
+	same board they would see in a single process. Agents that migrate into a strip only start acting in the next time step.
+*/
+class ShardedSimulation {
+private:
+	///The communicator used to talk to the other strips
+	Communicator* communicator;
+	///The strip of the board stored by this process
+	SimulationBoard* board;
+	///The number of rows in the whole board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The global index of the first row owned by this process
+	unsigned int firstOwnedRow;
+	///The global index one past the last row owned by this process
+	unsigned int endOwnedRow;
+	///The number of ghost rows stored on each side of the strip
+	unsigned int numOfGhostRows;
+	///The window through which the board is printed
+	BoardRenderer* renderer;
+	///The agents residing in the rows owned by this process
+	std::vector<Agent*> agentList;
+	///The agents that migrated into this strip during the current time step. They join agentList at the end of the step
+	std::vector<Agent*> arrivedAgents;
+	///The condition the user chose to run until. Only held by rank 0, which decides for all strips when it is met
+	StopCondition* stopCondition;
+	///True on every rank while the simulation is running until a condition is met
+	bool runningUntilCondition;
+
+	/**Returns the first row owned by a process
+	\param processRank The rank of the process
+	\return The global index of the first row owned by the process
+	*/
+	unsigned int firstRowOf(int processRank);
+
+	/**Places this strip's share of the initial agents at random in the rows owned by this process. The agents are split between the
+	strips in proportion to their number of rows, and the roadrunners are spread evenly among them
+	\param initialNumOfRoadrunners The initial number of roadrunners in the whole board
+	\param initialNumOfCoyotes The initial number of coyotes in the whole board
+	*/
+	void placeAgentsRandomly(unsigned int initialNumOfRoadrunners, unsigned int initialNumOfCoyotes);
+
+	/**Calls act() on every agent owned by this process, in random order
+	*/
+	void actAll();
+
+	/**Sends the boundary rows and the migrating agents to both neighbors, and applies the ones received from them
+	*/
+	void exchangeWithNeighbors();
+
+	/**Packs the rows next to a neighbor and the agents that moved into the neighbor's rows into a message. The migrating agents are
+	removed from agentList
+	\param neighbor The rank of the neighbor
+	\return The message to send to the neighbor
+	*/
+	std::vector<char> packForNeighbor(int neighbor);
+
+	/**Applies a message received from a neighbor: overwrites the ghost rows and recreates the migrating agents
+	\param neighbor The rank of the neighbor
+	\param message The message received from the neighbor
+	*/
+	void unpackFromNeighbor(int neighbor, const std::vector<char> &message);
+
+	/**Sums the number of agents, roadrunners and coyotes over all strips. Must be called by every process
+	\return The three totals, in that order
+	*/
+	std::vector<unsigned long> totals();
+
+	/**Prints the window of the board on rank 0. Every strip counts the blocks of the window in its own rows, and only the counts are
+	summed on rank 0. Must be called by every process
+	*/
+	void printBoard();
+
+	/**Prints the menu and reads the user's choice on rank 0, and hands the choice to every process. If the user chooses to run until a
+	condition is met, rank 0 also reads the condition. Must be called by every process
+	\param menuLogic The function that converts the user's menu choice into a number of time steps to skip
+	\param printOptions The function that prints the menu
+	\param readStopCondition The function that reads the condition to run until, given the current numbers of coyotes and roadrunners
+	\return The number of time steps to skip, as returned by menuLogic
+	*/
+	int readChoice(int (*menuLogic)(char), void (*printOptions)(), StopCondition* (*readStopCondition)(unsigned long, unsigned long));
+
+	/**Checks on rank 0 whether the condition chosen by the user is met, and hands the answer to every process. Must be called by
+	every process
+	\return True if the condition is met
+	*/
+	bool stopConditionMet();
+public:
+	///The number of ghost rows needed on each side of a strip. A roadrunner next to the strip's edge can move maxStepsPerMove rows into
+	///a neighbor and give birth one row further (the reach of the von Neumann neighborhood, the only one allowed with shards). Babies act
+	///in the time step they are born, so the baby can move maxStepsPerMove rows further again and count the coyotes one row beyond that
+	static const unsigned int haloRows = 2 * (Roadrunner::maxStepsPerMove + 1);
+
+	/**
+		The constructor for the ShardedSimulation class. Each process places its share of the initial agents in its own rows, drawing
+		from a random sequence derived from the shared seed and its rank
+		\param communicator The communicator used to talk to the other strips
+		\param numOfRows The number of rows in the whole board
+		\param numOfColumns The number of columns in the board
+		\param initialNumOfRoadrunners The initial number of roadrunners in the whole board
+		\param initialNumOfCoyotes The initial number of coyotes in the whole board
+		\param seed The seed shared by all processes
+		\param renderer The window through which the board is printed. Every process must set up the same window. Owned by the caller
+		\param numOfGhostRows The number of ghost rows stored on each side of the strip. At least haloRows. A strip with a ghost region as
+		large as the whole board sees exactly what a single process would, which the sharding check compares against
+	*/
+	ShardedSimulation(Communicator* communicator, unsigned int numOfRows, unsigned int numOfColumns, unsigned int initialNumOfRoadrunners,
+		unsigned int initialNumOfCoyotes, unsigned int seed, BoardRenderer* renderer, unsigned int numOfGhostRows = haloRows);
+
+	/**Deallocates the agents owned by this process and the strip
+	*/
+	~ShardedSimulation();
+
+	/**Runs one time step. Must be called by every process
+	*/
+	void step();
+
+	/**Computes the Zobrist hash of the whole board, equal to SimulationBoard::getHash() of the unsplit board. Each strip hashes its own rows.
+	Must be called by every process
+	\return The hash of the board on rank 0. 0 on the other processes
+	*/
+	unsigned long long hashBoard();
+
+	/**Runs the interactive simulation loop. Rank 0 prints the board and reads the user's choices, and the other ranks follow along
+	\param menuLogic The function that converts the user's menu choice into a number of time steps to skip, as used by main()
+	\param printOptions The function that prints the menu
+	\param readStopCondition The function that reads the condition to run until, as used by main()
+	*/
+	void run(int (*menuLogic)(char), void (*printOptions)(), StopCondition* (*readStopCondition)(unsigned long, unsigned long));
+};
+
+#endif
@@ -0,0 +1,442 @@
+#include "Simulation.h"
+#include "Coyote.h"
+#include "Roadrunner.h"
+#include "Hashing.h"
+#include "BoardLayout.h"
+#include "TerrainMap.h"
+#include "RandomSampling.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <memory>
+#include <fstream>
+#include <string>
+#include <thread>
+
+const unsigned long Simulation::repeatWindow;
+
+/**returns a random value to use in std::random_shuffle()
+*/
+static int myRandom(int i) {
+	return std::rand() % i;
+}
+
+
+Simulation::Simulation(const SimulationConfig &config, unsigned int seed) {
+	this->config = config;
+	//the size of the board is only known once the layout file has been read
+	std::unique_ptr<BoardLayout> layout;
+	if (!config.layoutFileName.empty()) {
+		layout.reset(new BoardLayout(config.layoutFileName.c_str()));
+		this->config.numOfRows = layout->getNumOfRows();
+		this->config.numOfColumns = layout->getNumOfColumns();
+		this->config.initialNumOfRoadrunners = layout->getNumOfRoadrunners();
+		this->config.initialNumOfCoyotes = layout->getNumOfCoyotes();
+	}
+	if (!config.framesFileName.empty() && config.frameInterval == 0) {
+		throw std::invalid_argument("The number of time steps between frames must be positive.");
+	}
+	//check to see if the roadrunners and coyotes can fit in the board
+	if ((unsigned long)this->config.initialNumOfCoyotes + this->config.initialNumOfRoadrunners > (unsigned long)this->config.numOfRows * this->config.numOfColumns) {
+		throw std::invalid_argument("Too many roadrunners and coyotes to fit in the board.");
+	}
+	//everything created from here on is released again if a later part throws
+	board = NULL;
+	synchronousUpdater = NULL;
+	telemetry = NULL;
+	frameExporter = NULL;
+	try {
+		board = SimulationBoard::create(this->config.numOfRows, this->config.numOfColumns);
+		board->setNeighborhood(Neighborhood(config.neighborhoodType, config.neighborhoodRadius));
+		if (!config.terrainFileName.empty()) {
+			board->loadTerrain(config.terrainFileName.c_str());
+			//coyotes cannot stand on walls, and roadrunners cannot stand on walls or in water
+			if ((unsigned long)this->config.initialNumOfCoyotes + this->config.initialNumOfRoadrunners > board->numOfHabitableCells(BoardOccupantTypes::coyote)
+				|| this->config.initialNumOfRoadrunners > board->numOfHabitableCells(BoardOccupantTypes::roadrunner)) {
+				throw std::invalid_argument("Too many roadrunners and coyotes to fit in the open cells of the terrain.");
+			}
+			if (layout) {
+				layout->visitAgents([&](unsigned int row, unsigned int column, BoardOccupantTypes type) {
+					if (!board->canHold(type, Coordinates(row, column))) {
+						throw std::invalid_argument("The layout puts an agent at row " + std::to_string(row + 1) + ", column " + std::to_string(column + 1) + ", where the terrain does not let it stand.");
+					}
+				});
+			}
+		}
+		if (config.trackClusters) {
+			board->enableClusterTracking();
+		}
+		if (config.pursuitDistance > 0) {
+			board->enablePursuit(config.pursuitDistance);
+		}
+		synchronousUpdater = new SynchronousUpdater(board);
+		stepNumber = 0;
+		stateHash = 0;
+		repeatedStep = -1;
+		numOfBirths = 0;
+		numOfDeaths = 0;
+		numOfKills = 0;
+		srand(seed);
+
+		if (layout) {
+			layout->visitAgents([&](unsigned int row, unsigned int column, BoardOccupantTypes type) {
+				addInitialAgent(type, Coordinates(row, column));
+			});
+		} else {
+			placeAgentsRandomly();
+		}
+
+		if (!config.telemetryFileName.empty()) {
+			telemetry = new TelemetrySegment(config.telemetryFileName.c_str(), true);
+			rateWindowStart = std::chrono::steady_clock::now();
+			rateWindowFirstStep = 0;
+			telemetrySample.stepsPerSecond = 0;
+			publishTelemetry(0, 0, 0);
+		}
+
+		if (!config.framesFileName.empty()) {
+			TerrainMap* terrain = board->getTerrain();
+			frameExporter = new FrameExporter(config.framesFileName.c_str(), this->config.numOfRows, this->config.numOfColumns, terrain != NULL ? terrain->getCells() : NULL,
+				config.frameScale, std::thread::hardware_concurrency());
+			//the first frame shows the board as the agents were placed
+			frameExporter->capture(board->getCells());
+		}
+	} catch (...) {
+		releaseResources();
+		throw;
+	}
+}
+
+void Simulation::addInitialAgent(BoardOccupantTypes type, Coordinates location) {
+	if (type == BoardOccupantTypes::roadrunner) {
+		agentList.push_back(new Roadrunner(board, location));
+	} else {
+		agentList.push_back(new Coyote(board, location));
+	}
+}
+
+void Simulation::placeAgentsRandomly() {
+	unsigned long numOfCells = (unsigned long)config.numOfRows * config.numOfColumns;
+	unsigned long numOfAgents = (unsigned long)config.initialNumOfRoadrunners + config.initialNumOfCoyotes;
+	if (board->getTerrain() == NULL) {
+		//every cell can hold either species, so the cells are drawn without listing them. The roadrunners are added first, then the coyotes
+		drawDistinct(numOfCells, numOfAgents, [&](unsigned long i, unsigned long cell) {
+			addInitialAgent(i < config.initialNumOfRoadrunners ? BoardOccupantTypes::roadrunner : BoardOccupantTypes::coyote,
+				Coordinates(cell / config.numOfColumns, cell % config.numOfColumns));
+		});
+		return;
+	}
+	//the cells a roadrunner can stand on are listed first, then the water, on which only coyotes can stand. A partial Fisher-Yates
+	//shuffle draws the roadrunners from the first part of the list, then the coyotes from whatever is left of the whole list, so every
+	//agent lands on a cell it can stand on with one draw. The constructor has checked that enough cells are left for every agent
+	std::vector<unsigned long> habitableCells;
+	habitableCells.reserve(board->numOfHabitableCells(BoardOccupantTypes::coyote));
+	for (unsigned long cell = 0; cell < numOfCells; cell++) {
+		if (board->canHold(BoardOccupantTypes::roadrunner, Coordinates(cell / config.numOfColumns, cell % config.numOfColumns))) {
+			habitableCells.push_back(cell);
+		}
+	}
+	unsigned long numOfDryCells = habitableCells.size();
+	for (unsigned long cell = 0; cell < numOfCells; cell++) {
+		Coordinates location(cell / config.numOfColumns, cell % config.numOfColumns);
+		if (!board->canHold(BoardOccupantTypes::roadrunner, location) && board->canHold(BoardOccupantTypes::coyote, location)) {
+			habitableCells.push_back(cell);
+		}
+	}
+	for (unsigned long i = 0; i < numOfAgents; i++) {
+		bool roadrunner = i < config.initialNumOfRoadrunners;
+		unsigned long j = i + randomIndex((roadrunner ? numOfDryCells : habitableCells.size()) - i);
+		std::swap(habitableCells[i], habitableCells[j]);
+		addInitialAgent(roadrunner ? BoardOccupantTypes::roadrunner : BoardOccupantTypes::coyote,
+			Coordinates(habitableCells[i] / config.numOfColumns, habitableCells[i] % config.numOfColumns));
+	}
+}
+
+Simulation::~Simulation() {
+	releaseResources();
+}
+
+void Simulation::releaseResources() {
+	//deallocate pointers
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		delete agentList[i];
+	}
+	agentList.clear();
+	//the frames still being encoded refer to the terrain of the board
+	delete frameExporter;
+	delete synchronousUpdater;
+	delete board;
+	delete telemetry;
+}
+
+void Simulation::shuffleAgents(unsigned int indexToStartShuffleFrom) {
+	std::random_shuffle(agentList.begin() + indexToStartShuffleFrom, agentList.end(), myRandom);
+}
+
+void Simulation::cleanAgentList() {
+	std::vector<Agent*> tempVector = agentList;
+	agentList.clear();
+	for (unsigned int i = 0; i < tempVector.size(); i++) {
+		if (!(tempVector[i]->isAlive())) {
+			delete tempVector[i];
+		}
+		else {
+			agentList.push_back(tempVector[i]);
+		}
+	}
+}
+
+void Simulation::step(const std::function<void()> &afterEachAct) {
+	//the phases are only timed when they are published, so that an unmonitored run does not read the clock
+	std::chrono::steady_clock::time_point phaseStart;
+	unsigned long long actNanoseconds = 0, cleanupNanoseconds = 0, hashNanoseconds = 0;
+	if (telemetry != NULL) {
+		phaseStart = std::chrono::steady_clock::now();
+	}
+	//in pursuit mode, the coyotes chase the roadrunners where they stood at the start of the time step, so the distances to them are
+	//repaired once per time step rather than after every move
+	board->updatePursuit();
+	unsigned long numOfRoadrunnersBefore = board->numOfRoadRunners();
+	unsigned long numOfOccupantsBefore = numOfRoadrunnersBefore + board->numOfCoyotes();
+	unsigned long numOfAgentsBefore = agentList.size();
+	unsigned long numOfRoadrunnerBirths = 0;
+	if (config.synchronousUpdate) {
+		//in the synchronous mode, all agents act at once, so the board can only be looked at between time steps
+		synchronousUpdater->step(agentList);
+		//the babies are appended to agentList
+		for (unsigned long i = numOfAgentsBefore; i < agentList.size(); i++) {
+			numOfRoadrunnerBirths += agentList[i]->getType() == BoardOccupantTypes::roadrunner;
+		}
+		if (afterEachAct) {
+			afterEachAct();
+		}
+	} else {
+		Agent* temp = NULL;
+		//shuffle agents each time step
+		shuffleAgents(0);
+		for (unsigned int i = 0; i < agentList.size(); i++) {
+			//each agent's act() function is called
+			temp = (agentList[i])->act();
+			//if the agent returns a baby agent, the baby is added to agentList
+			if (temp != NULL) {
+				numOfRoadrunnerBirths += temp->getType() == BoardOccupantTypes::roadrunner;
+				agentList.push_back(temp);
+				shuffleAgents(i + 1);
+			}
+			if (afterEachAct) {
+				afterEachAct();
+			}
+		}
+	}
+	//agents only leave agentList in cleanAgentList()
+	numOfBirths = agentList.size() - numOfAgentsBefore;
+	if (telemetry != NULL) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		actNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count();
+		phaseStart = now;
+	}
+
+	//clear list of dead agents
+	cleanAgentList();
+	stepNumber++;
+	//roadrunners only leave the board by being eaten, so the kills follow from the populations. An eaten roadrunner may stay in
+	//agentList until its next act(), so the deaths are counted on the board rather than in agentList
+	numOfKills = numOfRoadrunnersBefore + numOfRoadrunnerBirths - board->numOfRoadRunners();
+	numOfDeaths = numOfOccupantsBefore + numOfBirths - board->numOfRoadRunners() - board->numOfCoyotes();
+	if (telemetry != NULL) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		cleanupNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now - phaseStart).count();
+		phaseStart = now;
+	}
+
+	if (config.hashTrace || config.stopOnRepeat) {
+		stateHash = computeStateHash();
+	}
+	if (config.stopOnRepeat) {
+		std::pair<std::unordered_map<unsigned long long, unsigned long>::iterator, bool> entry = stepOfStateHash.insert(std::make_pair(stateHash, stepNumber));
+		if (!entry.second) {
+			repeatedStep = entry.first->second;
+			//the run has gone around a cycle, so the hashes seen so far are not needed anymore
+			stepOfStateHash.clear();
+			recentStateHashes.clear();
+		} else {
+			recentStateHashes.push_back(stateHash);
+			if (recentStateHashes.size() > repeatWindow) {
+				stepOfStateHash.erase(recentStateHashes.front());
+				recentStateHashes.pop_front();
+			}
+		}
+	}
+	if (telemetry != NULL) {
+		hashNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - phaseStart).count();
+		publishTelemetry(actNanoseconds, cleanupNanoseconds, hashNanoseconds);
+	}
+	if (frameExporter != NULL && stepNumber % config.frameInterval == 0) {
+		frameExporter->capture(board->getCells());
+	}
+}
+
+void Simulation::publishTelemetry(unsigned long long actNanoseconds, unsigned long long cleanupNanoseconds, unsigned long long hashNanoseconds) {
+	//the rate is measured over windows of about half a second, so that it neither jumps around every step nor lags far behind
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	double windowSeconds = std::chrono::duration<double>(now - rateWindowStart).count();
+	if (windowSeconds >= 0.5) {
+		telemetrySample.stepsPerSecond = (stepNumber - rateWindowFirstStep) / windowSeconds;
+		rateWindowStart = now;
+		rateWindowFirstStep = stepNumber;
+	}
+	telemetrySample.stepNumber = stepNumber;
+	telemetrySample.numOfRoadrunners = board->numOfRoadRunners();
+	telemetrySample.numOfCoyotes = board->numOfCoyotes();
+	telemetrySample.numOfBirths = numOfBirths;
+	telemetrySample.numOfDeaths = numOfDeaths;
+	telemetrySample.numOfKills = numOfKills;
+	telemetrySample.actNanoseconds = actNanoseconds;
+	telemetrySample.cleanupNanoseconds = cleanupNanoseconds;
+	telemetrySample.hashNanoseconds = hashNanoseconds;
+	telemetrySample.numOfRows = config.numOfRows;
+	telemetrySample.numOfColumns = config.numOfColumns;
+	telemetrySample.finished = finished();
+	telemetry->publish(telemetrySample);
+}
+
+unsigned long long Simulation::computeStateHash() {
+	//the agents are combined with XOR, so the hash does not depend on the order of agentList
+	unsigned long long hash = board->getHash();
+	//a roadrunner that was eaten stays in agentList until its next act(), on the cell of the coyote that ate it, so only the living
+	//agents are counted
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		if (!agentList[i]->isAlive()) {
+			continue;
+		}
+		AgentState state = agentList[i]->getState();
+		//the cell and the type are combined as in the Zobrist keys of the board, so a coyote and a roadrunner with the same countdowns
+		//on the same cell differ
+		unsigned long long key = (unsigned long long)state.row * config.numOfColumns * 3 + state.column * 3 + (unsigned long long)state.type;
+		hash ^= mixBits((key << 16) ^ (state.breedCountdown << 8) ^ state.timeSinceLastMeal);
+	}
+	return hash;
+}
+
+unsigned long long Simulation::getStateHash() {
+	return stateHash ^ mixBits(~(unsigned long long)stepNumber);
+}
+
+long Simulation::getRepeatedStep() {
+	return repeatedStep;
+}
+
+unsigned long Simulation::step(unsigned long numOfSteps) {
+	unsigned long stepsRun = 0;
+	while (stepsRun < numOfSteps && !finished()) {
+		step(std::function<void()>());
+		stepsRun++;
+	}
+	return stepsRun;
+}
+
+void Simulation::saveCheckpoint(const char* fileName) {
+	std::ofstream file(fileName);
+	if (!file.is_open()) {
+		throw std::invalid_argument(std::string("Unable to write ") + fileName + ".");
+	}
+	//a roadrunner that has been eaten only notices on its next act(), so between time steps agentList can still hold roadrunners whose
+	//cell has been taken by a coyote, or by another roadrunner since. Only the agents the board agrees with are saved, once per cell
+	std::vector<AgentState> states;
+	std::vector<bool> cellSaved((unsigned long)config.numOfRows * config.numOfColumns, false);
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		AgentState state = agentList[i]->getState();
+		unsigned long cell = (unsigned long)state.row * config.numOfColumns + state.column;
+		if (agentList[i]->isAlive() && board->existsHere(state.type, agentList[i]->getLocation()) && !cellSaved[cell]) {
+			cellSaved[cell] = true;
+			states.push_back(state);
+		}
+	}
+	file << "checkpoint " << config.numOfRows << " " << config.numOfColumns << " " << stepNumber << " " << states.size() << std::endl;
+	//one line per agent: type, row, column, breed countdown, time since last meal
+	for (unsigned int i = 0; i < states.size(); i++) {
+		file << (states[i].type == BoardOccupantTypes::coyote ? 'C' : 'R') << " " << states[i].row << " " << states[i].column << " " << states[i].breedCountdown << " " << states[i].timeSinceLastMeal << std::endl;
+	}
+	if (!file) {
+		throw std::invalid_argument(std::string("Unable to write ") + fileName + ".");
+	}
+}
+
+void Simulation::loadCheckpoint(const char* fileName) {
+	std::ifstream file(fileName);
+	if (!file.is_open()) {
+		throw std::invalid_argument(std::string("Unable to open ") + fileName + ".");
+	}
+	std::string header;
+	unsigned int numOfRows, numOfColumns;
+	unsigned long savedStepNumber, numOfAgents;
+	if (!(file >> header >> numOfRows >> numOfColumns >> savedStepNumber >> numOfAgents) || header != "checkpoint") {
+		throw std::invalid_argument(std::string(fileName) + " is not a checkpoint file.");
+	}
+	if (numOfRows != config.numOfRows || numOfColumns != config.numOfColumns) {
+		throw std::invalid_argument(std::string(fileName) + " was saved from a board of a different size.");
+	}
+	//read every agent before touching the board, so that a malformed file leaves the simulation as it was
+	std::vector<AgentState> states(numOfAgents);
+	std::vector<bool> cellTaken((unsigned long)numOfRows * numOfColumns, false);
+	for (unsigned long i = 0; i < numOfAgents; i++) {
+		char glyph;
+		if (!(file >> glyph >> states[i].row >> states[i].column >> states[i].breedCountdown >> states[i].timeSinceLastMeal) || (glyph != 'C' && glyph != 'R')
+			|| states[i].row >= numOfRows || states[i].column >= numOfColumns || cellTaken[(unsigned long)states[i].row * numOfColumns + states[i].column]
+			|| !board->canHold(glyph == 'C' ? BoardOccupantTypes::coyote : BoardOccupantTypes::roadrunner, Coordinates(states[i].row, states[i].column))) {
+			throw std::invalid_argument(std::string("Agent ") + std::to_string(i + 1) + " of " + fileName + " is invalid.");
+		}
+		cellTaken[(unsigned long)states[i].row * numOfColumns + states[i].column] = true;
+		states[i].type = glyph == 'C' ? BoardOccupantTypes::coyote : BoardOccupantTypes::roadrunner;
+	}
+
+	for (unsigned int i = 0; i < agentList.size(); i++) {
+		board->removeAgent(agentList[i]->getLocation());
+		delete agentList[i];
+	}
+	agentList.clear();
+	for (unsigned long i = 0; i < numOfAgents; i++) {
+		agentList.push_back(Agent::fromState(board, states[i]));
+	}
+	stepNumber = savedStepNumber;
+	stepOfStateHash.clear();
+	recentStateHashes.clear();
+	repeatedStep = -1;
+	numOfBirths = 0;
+	numOfDeaths = 0;
+	numOfKills = 0;
+	if (telemetry != NULL) {
+		rateWindowStart = std::chrono::steady_clock::now();
+		rateWindowFirstStep = stepNumber;
+		publishTelemetry(0, 0, 0);
+	}
+}
+
+bool Simulation::finished() {
+	return agentList.size() == 0 || board->numOfRoadRunners() >= board->numOfHabitableCells(BoardOccupantTypes::roadrunner) || repeatedStep != -1;
+}
+
+SimulationStats Simulation::getStats() {
+	SimulationStats stats;
+	stats.stepNumber = stepNumber;
+	stats.numOfRoadrunners = board->numOfRoadRunners();
+	stats.numOfCoyotes = board->numOfCoyotes();
+	stats.numOfBirths = numOfBirths;
+	stats.numOfDeaths = numOfDeaths;
+	stats.numOfKills = numOfKills;
+	stats.finished = finished();
+	return stats;
+}
+
+BoardView Simulation::getBoardView() {
+	BoardView view;
+	view.cells = board->getCells();
+	view.numOfRows = board->getNumOfRows();
+	view.numOfColumns = board->getNumOfColumns();
+	view.rowStride = board->getRowStride();
+	return view;
+}
+
+SimulationBoard* Simulation::getBoard() {
+	return board;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "Agent.h"
+#include "SimulationConfig.h"
+#include "SynchronousUpdater.h"
+#include "TelemetrySegment.h"
+#include "FrameExporter.h"
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <deque>
+#include <chrono>
+
+
+/**
+	The population counts of a simulation at the end of a time step
+*/
+struct SimulationStats {
+	///The number of time steps run so far
+	unsigned long stepNumber;
+	///The number of roadrunners on the board
+	unsigned long numOfRoadrunners;
+	///The number of coyotes on the board
+	unsigned long numOfCoyotes;
+	///The number of agents born during the last time step
+	unsigned long numOfBirths;
+	///The number of agents that left the board during the last time step: starved coyotes and eaten roadrunners
+	unsigned long numOfDeaths;
+	///The number of roadrunners eaten during the last time step
+	unsigned long numOfKills;
+	///True if the simulation has ended (no agents left, or the board is full of roadrunners)
+	bool finished;
+};
+
+/**
+	A read-only view of the board buffer of a simulation. Cell (row, column) is at cells[row * rowStride + column]. The view is not a
+	copy: it stays valid until the simulation is next stepped
+*/
+struct BoardView {
+	///The first cell of the board buffer
+	const BoardOccupantTypes* cells;
+	///The number of rows in the board
+	unsigned int numOfRows;
+	///The number of columns in the board
+	unsigned int numOfColumns;
+	///The distance between the first cells of two consecutive rows, in cells
+	unsigned long rowStride;
+};
+
+/**
+	A complete Coyote-Roadrunner simulation: a board of its own, the agents on it, and the time step loop. This is the C++ interface of
+	the coyoteroadrunner library, used by the simulator program and by other programs that run simulations in-process.
+
+	The agents draw their random numbers from rand(), so simulations that run in the same process share one random sequence and must not
+	be stepped from several threads at once.
+*/
+class Simulation {
+private:
+	///The settings the simulation was created with
+	SimulationConfig config;
+	///The board on which the simulation is run. Owned by the simulation
+	SimulationBoard* board;
+	///The list of all agents in the simulation
+	std::vector<Agent*> agentList;
+	///Runs the time steps in the synchronous update mode
+	SynchronousUpdater* synchronousUpdater;
+	///The number of time steps run so far
+	unsigned long stepNumber;
+	///The hash of the state of the simulation after the last time step, without the step number. Only kept up to date if the config asks
+	///for hash tracing or repeat detection
+	unsigned long long stateHash;
+	///The time step at which each state hash was first seen, for the last repeatWindow time steps. Only filled in if the config asks
+	///for repeat detection
+	std::unordered_map<unsigned long long, unsigned long> stepOfStateHash;
+	///The state hashes in stepOfStateHash, oldest first
+	std::deque<unsigned long long> recentStateHashes;
+	///The number of time steps looked back at for a repeated state, so that the memory used does not grow with the length of the run
+	static const unsigned long repeatWindow = 65536;
+	///The earlier time step whose state the last time step repeated, or -1 if no state has repeated
+	long repeatedStep;
+	///The number of agents born during the last time step
+	unsigned long numOfBirths;
+	///The number of agents that left the board during the last time step
+	unsigned long numOfDeaths;
+	///The number of roadrunners eaten during the last time step
+	unsigned long numOfKills;
+	///The file the figures of every time step are published to. NULL unless the config names a telemetry file
+	TelemetrySegment* telemetry;
+	///The sample last published to the telemetry file
+	TelemetrySample telemetrySample;
+	///The time at which the steps per second started being measured again
+	std::chrono::steady_clock::time_point rateWindowStart;
+	///The time step at which the steps per second started being measured again
+	unsigned long rateWindowFirstStep;
+	///Writes the board as a sequence of images. NULL unless the config names a frames file
+	FrameExporter* frameExporter;
+
+	/**Computes the hash of the state of the simulation: the Zobrist hash the board keeps up to date, combined with the location, type and
+	countdowns of every living agent
+	\return The state hash, without the step number
+	*/
+	unsigned long long computeStateHash();
+
+	/**Publishes the figures of the last time step to the telemetry file
+	\param actNanoseconds The time spent by the agents acting
+	\param cleanupNanoseconds The time spent removing dead agents
+	\param hashNanoseconds The time spent hashing the state
+	*/
+	void publishTelemetry(unsigned long long actNanoseconds, unsigned long long cleanupNanoseconds, unsigned long long hashNanoseconds);
+
+	/**
+		Shuffles the order of the agents in a specified portion of the agentList vector
+		\param indexToStartShuffleFrom The index of the vector after which the vector is shuffled. All elements of the vector before this index remain unchanged
+	*/
+	void shuffleAgents(unsigned int indexToStartShuffleFrom);
+
+	/**Goes through the agentList vector and looks at each agent to see which one is marked dead. If the agent is marked dead, then it
+		removes the agent from the vector. Deallocates all pointers of the dead agents as well
+	*/
+	void cleanAgentList();
+
+	/**Places the initial agents given by the config in random unoccupied locations that their terrain lets them stand on, all such
+	locations being equally likely
+	*/
+	void placeAgentsRandomly();
+
+	/**Creates an agent and adds it to agentList
+	\param type The type of the agent
+	\param location The location of the agent
+	*/
+	void addInitialAgent(BoardOccupantTypes type, Coordinates location);
+
+	/**Deallocates the agents, the board and everything else the simulation owns. Used by the destructor, and by the constructor if it throws
+	part way through
+	*/
+	void releaseResources();
+public:
+	/**
+		The constructor for the Simulation class. Creates the board and places the initial agents in random unoccupied locations, or where the
+		layout file named in the config puts them. Throws an invalid_argument exception if the agents do not fit, or if the layout or terrain file is invalid
+		\param config The settings of the simulation. The shards setting is ignored; sharded runs are handled by ShardedSimulation
+		\param seed The seed for rand()
+	*/
+	Simulation(const SimulationConfig &config, unsigned int seed);
+
+	/**Deallocates the agents and the board, unmaps the telemetry file, and waits for the frames captured to be written
+	*/
+	~Simulation();
+
+	/**Runs one time step. Throws a runtime_error exception if an earlier frame could not be written
+	\param afterEachAct Called after every act() in the random-sequential mode, or once after the whole time step in the synchronous mode.
+	Used by the simulator to print the board in the middle of a time step
+	*/
+	void step(const std::function<void()> &afterEachAct);
+
+	/**Runs several time steps, stopping early if the simulation ends
+	\param numOfSteps The number of time steps to run
+	\return The number of time steps actually run
+	*/
+	unsigned long step(unsigned long numOfSteps);
+
+	/**Checks if the simulation has ended
+	\return True if no agents are left, if every cell roadrunners can stand on holds one, or if repeat detection is on and the state has repeated
+	*/
+	bool finished();
+
+	/**Returns the hash of the state of the simulation combined with the step number. Two runs that print the same sequence of hashes
+	went through the same states. Only kept up to date if the config asks for hash tracing or repeat detection
+	\return The hash
+	*/
+	unsigned long long getStateHash();
+
+	/**Returns the earlier time step whose state the current one repeats. Only detected if the config asks for repeat detection
+	\return The earlier time step, or -1 if the state has not repeated
+	*/
+	long getRepeatedStep();
+
+	/**Writes the state of the simulation (the size of the board, the step number and the state of every agent) to a text file. Throws an
+	invalid_argument exception if the file cannot be written
+	\param fileName The name of the file
+	*/
+	void saveCheckpoint(const char* fileName);
+
+	/**Replaces the agents and the step number of the simulation with those saved by saveCheckpoint(). The state of rand() is not saved,
+	so the run continues from the same state but not with the same random draws. Throws an invalid_argument exception if the file cannot
+	be read, is malformed or was saved from a board of a different size
+	\param fileName The name of the file
+	*/
+	void loadCheckpoint(const char* fileName);
+
+	/**Returns the population counts of the simulation
+	\return The current stats
+	*/
+	SimulationStats getStats();
+
+	/**Returns a read-only view of the board buffer, without copying it
+	\return The view
+	*/
+	BoardView getBoardView();
+
+	/**Returns the board on which the simulation is run
+	\return The board. Owned by the simulation
+	*/
+	SimulationBoard* getBoard();
+};
+
+#endif
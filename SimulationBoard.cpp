@@ -1,8 +1,20 @@
 #include "SimulationBoard.h"
+#include "ClusterTracker.h"
+#include "OccupancyPyramid.h"
+#include "PreyDistanceField.h"
+#include "TerrainMap.h"
+#include "Hashing.h"
 #include <stdexcept>
+#include <algorithm>
 
 SimulationBoard* SimulationBoard::boardInstance;
 
+const unsigned char SimulationBoard::hiddenTerrain[3][3] = {
+	{ TerrainFlags::wall, 0, 0 },
+	{ TerrainFlags::wall, 0, TerrainFlags::cover },
+	{ TerrainFlags::wall | TerrainFlags::water, 0, 0 }
+};
+
 SimulationBoard* SimulationBoard::get_instance(unsigned int numOfRows, unsigned int numOfColumns) {
 	if(!boardInstance) {
 		boardInstance = new SimulationBoard(numOfRows, numOfColumns);
@@ -10,29 +22,53 @@ SimulationBoard* SimulationBoard::get_instance(unsigned int numOfRows, unsigned
 	return boardInstance;
 }
 
-SimulationBoard::SimulationBoard(unsigned int numOfRows, unsigned int numOfColumns) {
+SimulationBoard* SimulationBoard::create(unsigned int numOfRows, unsigned int numOfColumns) {
+	return new SimulationBoard(numOfRows, numOfColumns);
+}
+
+SimulationBoard* SimulationBoard::createStrip(unsigned int firstRow, unsigned int numOfRows, unsigned int numOfColumns) {
+	return new SimulationBoard(firstRow, numOfRows, numOfColumns);
+}
+
+SimulationBoard::SimulationBoard(unsigned int numOfRows, unsigned int numOfColumns) : SimulationBoard(0, numOfRows, numOfColumns) {
+
+}
+
+SimulationBoard::SimulationBoard(unsigned int firstRow, unsigned int numOfRows, unsigned int numOfColumns) {
+	this->rowOffset = firstRow;
+	this->clusterTracker = NULL;
+	this->preyField = NULL;
+	this->terrainMap = NULL;
+	this->terrain = NULL;
 	this->numOfRows = numOfRows;
 	this->numOfColumns = numOfColumns;
-	for (unsigned int i = 0; i < numOfRows; i++) {
-		board.push_back(std::vector<BoardOccupantTypes>());
-		for (unsigned int j = 0; j < numOfColumns; j++) {
-			board[i].push_back(BoardOccupantTypes::unoccupied);
-		}
-	}
+	board.assign((unsigned long)numOfRows * numOfColumns, BoardOccupantTypes::unoccupied);
+	occupantCount[(int)BoardOccupantTypes::unoccupied] = board.size();
+	occupantCount[(int)BoardOccupantTypes::coyote] = 0;
+	occupantCount[(int)BoardOccupantTypes::roadrunner] = 0;
+	boardHash = 0;
+	occupancy = new OccupancyPyramid(numOfRows, numOfColumns);
+}
+
+SimulationBoard::~SimulationBoard() {
+	delete occupancy;
+	delete clusterTracker;
+	delete preyField;
+	delete terrainMap;
 }
 
 void SimulationBoard::addAgent(BoardOccupantTypes agentType, Coordinates location) {
 	if(outOfBounds(location)) {
 		throw std::invalid_argument("Invalid location");
 	}
-	board[location.getRow()][location.getColumn()] = agentType;
+	setCell(location.getRow() - rowOffset, location.getColumn(), agentType);
 }
 
 void SimulationBoard::removeAgent(Coordinates location) {
 	if(outOfBounds(location)) {
 		throw std::invalid_argument("Invalid location");
 	}
-	board[location.getRow()][location.getColumn()] = BoardOccupantTypes::unoccupied;
+	setCell(location.getRow() - rowOffset, location.getColumn(), BoardOccupantTypes::unoccupied);
 }
 
 void SimulationBoard::moveAgent(Coordinates sourceLocation, Coordinates destinationLocation) {
@@ -40,72 +76,354 @@ void SimulationBoard::moveAgent(Coordinates sourceLocation, Coordinates destinat
 	if ((sourceLocation.getRow() == destinationLocation.getRow()) && (sourceLocation.getColumn() == destinationLocation.getColumn())) {
 		return;
 	}
-	board[destinationLocation.getRow()][destinationLocation.getColumn()] = board[sourceLocation.getRow()][sourceLocation.getColumn()];
-	board[sourceLocation.getRow()][sourceLocation.getColumn()] = BoardOccupantTypes::unoccupied;
+	setCell(destinationLocation.getRow() - rowOffset, destinationLocation.getColumn(), board[cellIndex(sourceLocation.getRow() - rowOffset, sourceLocation.getColumn())]);
+	setCell(sourceLocation.getRow() - rowOffset, sourceLocation.getColumn(), BoardOccupantTypes::unoccupied);
 }
 
 bool SimulationBoard::outOfBounds(Coordinates location) {
-	return (location.getRow() < 0 || location.getRow() >= numOfRows || location.getColumn() < 0 || location.getColumn() >= numOfColumns);
+	return (location.getRow() < rowOffset || location.getRow() - rowOffset >= numOfRows || location.getColumn() < 0 || location.getColumn() >= numOfColumns);
 }
 
-bool SimulationBoard::existsHere(BoardOccupantTypes type, Coordinates location) {
-	return (!(outOfBounds(location)) && board[location.getRow()][location.getColumn()] == type);
+bool SimulationBoard::existsHere(BoardOccupantTypes type, Coordinates location, BoardOccupantTypes viewer) {
+	if (outOfBounds(location)) {
+		return false;
+	}
+	unsigned long cell = cellIndex(location.getRow() - rowOffset, location.getColumn());
+	return board[cell] == type && (terrain == NULL || (terrain[cell] & hiddenTerrain[(int)viewer][(int)type]) == 0);
 }
 
-unsigned int SimulationBoard::numOfCoyotes() {
-	unsigned int counter = 0;
-	for (unsigned int i = 0; i < numOfRows; i++) {
-		for (unsigned int j = 0; j < numOfColumns; j++) {
-			if (board[i][j] == BoardOccupantTypes::coyote) {
-				counter++;
-			}
+template <typename Stencil>
+unsigned long long SimulationBoard::stencilMask(const Stencil &stencil, unsigned int row, unsigned int column, const unsigned char* layer, unsigned char bits, unsigned char value) {
+	unsigned long long mask = 0;
+	unsigned int reach = stencil.getReach();
+	//away from the edges of the board every neighbor exists, so the neighbors are read without bounds checks
+	if (row >= reach && row + reach < numOfRows && column >= reach && column + reach < numOfColumns) {
+		const unsigned char* center = layer + cellIndex(row, column);
+		for (unsigned int i = 0; i < stencil.getSize(); i++) {
+			mask |= (unsigned long long)((center[(long)stencil.getRowOffset(i) * numOfColumns + stencil.getColumnOffset(i)] & bits) == value) << i;
 		}
+		return mask;
 	}
-	return counter;
+	for (unsigned int i = 0; i < stencil.getSize(); i++) {
+		long neighborRow = (long)row + stencil.getRowOffset(i);
+		long neighborColumn = (long)column + stencil.getColumnOffset(i);
+		if (neighborRow >= 0 && neighborRow < numOfRows && neighborColumn >= 0 && neighborColumn < numOfColumns && (layer[cellIndex(neighborRow, neighborColumn)] & bits) == value) {
+			mask |= 1ULL << i;
+		}
+	}
+	return mask;
+}
+
+template <typename Stencil>
+unsigned long long SimulationBoard::visibleMask(const Stencil &stencil, unsigned int row, unsigned int column, BoardOccupantTypes type, unsigned char hidden) {
+	unsigned long long mask = stencilMask(stencil, row, column, (const unsigned char*)board.data(), 0xff, (unsigned char)type);
+	//the neighbors whose terrain hides them are masked out in a second pass over the terrain, rather than tested one by one
+	if (hidden != 0) {
+		mask &= stencilMask(stencil, row, column, terrain, hidden, 0);
+	}
+	return mask;
+}
+
+unsigned long long SimulationBoard::neighborMask(Coordinates location, BoardOccupantTypes type, BoardOccupantTypes viewer) {
+	unsigned int row = location.getRow() - rowOffset;
+	unsigned int column = location.getColumn();
+	unsigned char hidden = terrain != NULL ? hiddenTerrain[(int)viewer][(int)type] : 0;
+	switch (neighborhood.getType()) {
+	case NeighborhoodTypes::vonNeumann:
+		return visibleMask(VonNeumannStencil(), row, column, type, hidden);
+	case NeighborhoodTypes::moore:
+		return visibleMask(MooreStencil(), row, column, type, hidden);
+	default:
+		return visibleMask(neighborhood, row, column, type, hidden);
+	}
+}
+
+bool SimulationBoard::canHold(BoardOccupantTypes type, Coordinates location) {
+	return terrain == NULL || (terrain[cellIndex(location.getRow() - rowOffset, location.getColumn())] & hiddenTerrain[(int)type][(int)BoardOccupantTypes::unoccupied]) == 0;
+}
+
+unsigned long long SimulationBoard::closerToPreyMask(Coordinates location) {
+	if (preyField == NULL) {
+		return 0;
+	}
+	return preyField->closerNeighbors(location.getRow() - rowOffset, location.getColumn());
+}
+
+void SimulationBoard::setNeighborhood(const Neighborhood &neighborhood) {
+	this->neighborhood = neighborhood;
+	//the distances are counted in steps through the neighborhood
+	if (preyField != NULL) {
+		preyField->setNeighborhood(neighborhood);
+		preyField->rebuild(board.data());
+	}
+}
+
+const Neighborhood& SimulationBoard::getNeighborhood() {
+	return neighborhood;
+}
+
+unsigned int SimulationBoard::numOfCoyotes() {
+	return occupantCount[(int)BoardOccupantTypes::coyote];
 }
 
 unsigned int SimulationBoard::numOfRoadRunners() {
-	unsigned int counter = 0;
-	for (unsigned int i = 0; i < numOfRows; i++) {
-		for (unsigned int j = 0; j < numOfColumns; j++) {
-			if (board[i][j] == BoardOccupantTypes::roadrunner) {
-				counter++;
-			}
+	return occupantCount[(int)BoardOccupantTypes::roadrunner];
+}
+
+
+bool SimulationBoard::boardIsEmpty() {
+	return occupantCount[(int)BoardOccupantTypes::unoccupied] == board.size();
+}
+
+unsigned int SimulationBoard::getNumOfRows() {
+	return numOfRows;
+}
+
+unsigned int SimulationBoard::getNumOfColumns() {
+	return numOfColumns;
+}
+
+unsigned int SimulationBoard::getRowOffset() {
+	return rowOffset;
+}
+
+std::vector<BoardOccupantTypes> SimulationBoard::copyRow(unsigned int row) {
+	if(row < rowOffset || row - rowOffset >= numOfRows) {
+		throw std::invalid_argument("Invalid row");
+	}
+	return std::vector<BoardOccupantTypes>(board.begin() + cellIndex(row - rowOffset, 0), board.begin() + cellIndex(row - rowOffset + 1, 0));
+}
+
+void SimulationBoard::overwriteRow(unsigned int row, const std::vector<BoardOccupantTypes> &contents) {
+	if(row < rowOffset || row - rowOffset >= numOfRows || contents.size() != numOfColumns) {
+		throw std::invalid_argument("Invalid row");
+	}
+	for (unsigned int j = 0; j < numOfColumns; j++) {
+		if (board[cellIndex(row - rowOffset, j)] != contents[j]) {
+			setCell(row - rowOffset, j, contents[j]);
 		}
 	}
-	return counter;
 }
 
+const BoardOccupantTypes* SimulationBoard::getCells() {
+	return board.data();
+}
 
-bool SimulationBoard::boardIsEmpty() {
-	for (unsigned int i = 0; i < numOfRows; i++) {
-		for (unsigned int j = 0; j < numOfColumns; j++) {
-			if (board[i][j] != BoardOccupantTypes::unoccupied) {
-				return false;
-			}
+unsigned long SimulationBoard::getRowStride() {
+	return numOfColumns;
+}
+
+void SimulationBoard::placeInBackBuffer(BoardOccupantTypes type, Coordinates location) {
+	if(outOfBounds(location)) {
+		throw std::invalid_argument("Invalid location");
+	}
+	if (backBoard.size() != board.size()) {
+		backBoard.resize(board.size());
+	}
+	unsigned long cell = cellIndex(location.getRow() - rowOffset, location.getColumn());
+	backBoard[cell] = type;
+	backBoardCells.push_back(cell);
+}
+
+void SimulationBoard::commitBackBuffer() {
+	for (unsigned long i = 0; i < backBoardCells.size(); i++) {
+		unsigned long cell = backBoardCells[i];
+		//a cell that is left by one agent and entered by another in the same time step may not change at all
+		if (board[cell] != backBoard[cell]) {
+			setCell(cell / numOfColumns, cell % numOfColumns, backBoard[cell]);
 		}
 	}
-	return true;
+	backBoardCells.clear();
 }
 
+void SimulationBoard::setCell(unsigned int row, unsigned int column, BoardOccupantTypes type) {
+	unsigned long cell = cellIndex(row, column);
+	if (clusterTracker != NULL) {
+		if (board[cell] != BoardOccupantTypes::unoccupied) {
+			clusterTracker->agentRemoved(cell);
+		}
+		if (type != BoardOccupantTypes::unoccupied) {
+			clusterTracker->agentAdded(type, cell);
+		}
+	}
+	occupantCount[(int)board[cell]]--;
+	occupantCount[(int)type]++;
+	boardHash ^= zobristKey(cell, board[cell]) ^ zobristKey(cell, type);
+	occupancy->cellChanged(row, column, board[cell], type);
+	if (preyField != NULL) {
+		preyField->cellChanged(row, column, board[cell], type);
+	}
+	board[cell] = type;
+}
 
-void SimulationBoard::printBoard() {
+unsigned long long SimulationBoard::zobristKey(unsigned long cell, BoardOccupantTypes type) {
+	if (type == BoardOccupantTypes::unoccupied) {
+		return 0;
+	}
+	return mixBits(cell * 3 + (unsigned long long)type);
+}
 
-	for (unsigned int i = 0; i < numOfRows; i++) {
-		for (unsigned int j = 0; j < numOfColumns; j++) {
-			switch (board[i][j]) {
-			case BoardOccupantTypes::unoccupied:
-				std::cout << "- ";
-				break;
-			case BoardOccupantTypes::coyote:
-				std::cout << "C ";
-				break;
-			case BoardOccupantTypes::roadrunner:
-				std::cout << "R ";
-				break;
+void SimulationBoard::clipToStrip(unsigned int &firstRow, unsigned int &numOfRectRows) {
+	if (firstRow < rowOffset) {
+		numOfRectRows = numOfRectRows > rowOffset - firstRow ? numOfRectRows - (rowOffset - firstRow) : 0;
+		firstRow = rowOffset;
+	}
+}
+
+unsigned long SimulationBoard::populationInRect(BoardOccupantTypes type, unsigned int firstRow, unsigned int firstColumn, unsigned int numOfRectRows, unsigned int numOfRectColumns) {
+	clipToStrip(firstRow, numOfRectRows);
+	return occupancy->countInRect(board.data(), type, firstRow - rowOffset, firstColumn, numOfRectRows, numOfRectColumns, board.size());
+}
+
+bool SimulationBoard::isRegionEmpty(unsigned int firstRow, unsigned int firstColumn, unsigned int numOfRectRows, unsigned int numOfRectColumns) {
+	clipToStrip(firstRow, numOfRectRows);
+	return occupancy->countInRect(board.data(), BoardOccupantTypes::coyote, firstRow - rowOffset, firstColumn, numOfRectRows, numOfRectColumns, 1) == 0
+		&& occupancy->countInRect(board.data(), BoardOccupantTypes::roadrunner, firstRow - rowOffset, firstColumn, numOfRectRows, numOfRectColumns, 1) == 0;
+}
+
+Coordinates SimulationBoard::findNearest(BoardOccupantTypes type, Coordinates location) {
+	Coordinates nearest = occupancy->findNearest(board.data(), type, location.getRow() - rowOffset, location.getColumn());
+	if (nearest.initialized()) {
+		nearest.setCoordinates(nearest.getRow() + rowOffset, nearest.getColumn());
+	}
+	return nearest;
+}
+
+OccupancyPyramid* SimulationBoard::getOccupancyPyramid() {
+	return occupancy;
+}
+
+unsigned long long SimulationBoard::getHash() {
+	return boardHash;
+}
+
+unsigned long long SimulationBoard::hashRows(unsigned int firstRow, unsigned int numOfHashedRows) {
+	if(firstRow < rowOffset || firstRow - rowOffset + numOfHashedRows > numOfRows) {
+		throw std::invalid_argument("Invalid row");
+	}
+	unsigned long long hash = 0;
+	for (unsigned long cell = cellIndex(firstRow - rowOffset, 0); cell < cellIndex(firstRow - rowOffset + numOfHashedRows, 0); cell++) {
+		hash ^= zobristKey(cell + (unsigned long)rowOffset * numOfColumns, board[cell]);
+	}
+	return hash;
+}
+
+void SimulationBoard::rebuildTrackers() {
+	for (int type = 0; type < 3; type++) {
+		occupantCount[type] = std::count(board.begin(), board.end(), (BoardOccupantTypes)type);
+	}
+	boardHash = 0;
+	for (unsigned long cell = 0; cell < board.size(); cell++) {
+		boardHash ^= zobristKey(cell, board[cell]);
+	}
+	occupancy->rebuild(board.data());
+	if (preyField != NULL) {
+		preyField->rebuild(board.data());
+	}
+	if (clusterTracker != NULL) {
+		clusterTracker->clear();
+		for (unsigned long cell = 0; cell < board.size(); cell++) {
+			if (board[cell] != BoardOccupantTypes::unoccupied) {
+				clusterTracker->agentAdded(board[cell], cell);
 			}
 		}
+	}
+}
+
+void SimulationBoard::enableClusterTracking() {
+	if (clusterTracker == NULL) {
+		clusterTracker = new ClusterTracker(numOfRows, numOfColumns);
+		rebuildTrackers();
+	}
+}
+
+ClusterTracker* SimulationBoard::getClusterTracker() {
+	return clusterTracker;
+}
+
+void SimulationBoard::enablePursuit(unsigned int maxDistance) {
+	if (preyField == NULL) {
+		preyField = new PreyDistanceField(numOfRows, numOfColumns, maxDistance, neighborhood);
+		preyField->setTerrain(terrain);
+		preyField->rebuild(board.data());
+	}
+}
+
+void SimulationBoard::updatePursuit() {
+	if (preyField != NULL) {
+		preyField->update(board.data());
+	}
+}
+
+PreyDistanceField* SimulationBoard::getPreyDistanceField() {
+	return preyField;
+}
+
+void SimulationBoard::loadTerrain(const char* fileName) {
+	TerrainMap* newTerrain = new TerrainMap(fileName);
+	if (newTerrain->getNumOfRows() != numOfRows || newTerrain->getNumOfColumns() != numOfColumns) {
+		delete newTerrain;
+		throw std::invalid_argument("The terrain file does not have the size of the board.");
+	}
+	delete terrainMap;
+	terrainMap = newTerrain;
+	terrain = terrainMap->getCells();
+	//the walls block the distances to the roadrunners, and the roadrunners in cover are out of sight
+	if (preyField != NULL) {
+		preyField->setTerrain(terrain);
+		preyField->rebuild(board.data());
+	}
+}
+
+TerrainMap* SimulationBoard::getTerrain() {
+	return terrainMap;
+}
+
+unsigned long SimulationBoard::numOfHabitableCells(BoardOccupantTypes type) {
+	if (terrainMap == NULL) {
+		return board.size();
+	}
+	return board.size() - (type == BoardOccupantTypes::roadrunner ? terrainMap->getNumOfWallsOrWater() : terrainMap->getNumOfWalls());
+}
+
+void SimulationBoard::printStats() {
+	if (clusterTracker == NULL) {
+		return;
+	}
+	const char* names[2] = { "Roadrunner colonies", "Coyote packs" };
+	BoardOccupantTypes types[2] = { BoardOccupantTypes::roadrunner, BoardOccupantTypes::coyote };
+	for (int i = 0; i < 2; i++) {
+		std::cout << names[i] << ": " << clusterTracker->getNumOfClusters(types[i]) << ", largest: " << clusterTracker->getLargestCluster(types[i]) << ", sizes:";
+		const std::map<unsigned long, unsigned long> &distribution = clusterTracker->getSizeDistribution(types[i]);
+		for (std::map<unsigned long, unsigned long>::const_iterator entry = distribution.begin(); entry != distribution.end(); ++entry) {
+			std::cout << " " << entry->first << "x" << entry->second;
+		}
 		std::cout << std::endl;
 	}
+	std::cout << std::endl;
+}
+
+void SimulationBoard::printRow(const BoardOccupantTypes* row, unsigned int numOfColumns) {
+	for (unsigned int j = 0; j < numOfColumns; j++) {
+		switch (row[j]) {
+		case BoardOccupantTypes::unoccupied:
+			std::cout << "- ";
+			break;
+		case BoardOccupantTypes::coyote:
+			std::cout << "C ";
+			break;
+		case BoardOccupantTypes::roadrunner:
+			std::cout << "R ";
+			break;
+		}
+	}
+	std::cout << std::endl;
+}
+
+void SimulationBoard::printBoard() {
+
+	for (unsigned int i = 0; i < numOfRows; i++) {
+		printRow(board.data() + cellIndex(i, 0), numOfColumns);
+	}
 	std::cout << std::endl << std::endl;
 }
@@ -4,12 +4,17 @@
 
 #include <vector>
 #include <iostream>
+#include "Neighborhood.h"
 
+class ClusterTracker;
+class OccupancyPyramid;
+class PreyDistanceField;
+class TerrainMap;
 
 /**
 	An enum class that describes the types of objects that can occupy the board.
 */
-enum class BoardOccupantTypes {
+enum class BoardOccupantTypes : unsigned char {
 	unoccupied, ///< if no object resides in a location in the board, then unoccupied is used instead
 	coyote, ///< if a Coyote object resides a location in the board, then enum type coyote is used
 	roadrunner ///< if a Roadrunner object resides a location in the board, then enum type roadrunner is used
@@ -94,12 +99,98 @@ The singleton class that defines the virtual board on which the Coyote-Roadrunne
 */
 class SimulationBoard {
 private:
-	///The number of rows in the board
+	///The number of rows stored in the board. For a strip of a sharded board, this includes the ghost rows
 	unsigned int numOfRows;
+	///The global index of the first row stored in the board. 0 unless the board is a strip of a sharded board
+	unsigned int rowOffset;
 	///The number of columns in the board
 	unsigned int numOfColumns;
-	///The two-dimensional vector that holds the list of all the objects that occupy the board
-	std::vector<std::vector<BoardOccupantTypes>> board;
+	///The occupants of every cell of the board, stored row after row in one contiguous buffer so that it can be handed out without copying
+	std::vector<BoardOccupantTypes> board;
+	///The second buffer used by the synchronous update mode. The cells that change in a time step are written here while board still holds
+	///the previous one. Only the cells listed in backBoardCells are meaningful
+	std::vector<BoardOccupantTypes> backBoard;
+	///The cells written into the back buffer since the last call to commitBackBuffer()
+	std::vector<unsigned long> backBoardCells;
+	///The number of cells holding each occupant type, indexed by the value of the type. Kept up to date by setCell()
+	unsigned long occupantCount[3];
+	///The Zobrist hash of the contents of the board: the XOR of the keys of every occupied cell. Kept up to date by setCell()
+	unsigned long long boardHash;
+	///The cells agents look at, move to and breed into around their location
+	Neighborhood neighborhood;
+	///Counts each species in tiles of the board at several scales. Kept up to date by setCell()
+	OccupancyPyramid* occupancy;
+	///Keeps track of the clusters of each species. NULL unless cluster tracking has been enabled
+	ClusterTracker* clusterTracker;
+	///The distance from every cell to the nearest roadrunner. NULL unless pursuit has been enabled
+	PreyDistanceField* preyField;
+	///The static terrain of the board. NULL unless a terrain map has been loaded
+	TerrainMap* terrainMap;
+	///The TerrainFlags of every cell, in the same order as the board buffer. NULL unless a terrain map has been loaded
+	const unsigned char* terrain;
+	///hiddenTerrain[viewer][type] holds the TerrainFlags that keep a cell holding type from being seen as such by an agent of type viewer:
+	///walls and water are not free for roadrunners, walls are not free for coyotes, and roadrunners in cover are not seen by coyotes
+	static const unsigned char hiddenTerrain[3][3];
+
+	/**Changes the occupant of a cell and informs the trackers that are kept up to date with the board. Every change to the board goes
+	through this function
+	\param row The index of the row in the board buffer (the global row minus rowOffset)
+	\param column The column of the cell
+	\param type The new occupant of the cell
+	*/
+	void setCell(unsigned int row, unsigned int column, BoardOccupantTypes type);
+
+	/**Returns the position of a cell in the board buffer
+	\param row The index of the row in the board buffer (the global row minus rowOffset)
+	\param column The column of the cell
+	\return The index of the cell in the board buffer
+	*/
+	unsigned long cellIndex(unsigned int row, unsigned int column) {
+		return (unsigned long)row * numOfColumns + column;
+	}
+
+	/**Returns the Zobrist key of an occupant in a cell. The keys are derived from the cell and type instead of being stored in a table,
+	so they cost no memory on large boards
+	\param cell The index of the cell in the board buffer
+	\param type The occupant of the cell
+	\return The key. 0 for an unoccupied cell
+	*/
+	static unsigned long long zobristKey(unsigned long cell, BoardOccupantTypes type);
+
+	/**Finds out which neighbors of a cell hold a given value in a layer of the board: the board buffer or the terrain. Templated on the
+	stencil, so that the loop over the neighbors of the common stencils is unrolled with their offsets built in. Also instantiated with
+	the board's Neighborhood, as the fallback for the other neighborhoods
+	\param stencil The neighbors to look at: VonNeumannStencil, MooreStencil or a Neighborhood
+	\param row The index of the row in the board buffer (the global row minus rowOffset)
+	\param column The column of the cell
+	\param layer One byte per cell, in the same order as the board buffer
+	\param bits The bits of each byte that are compared
+	\param value The value the compared bits must have
+	\return A neighbor mask with bit i set if neighbor i of the stencil lies inside the board and (layer & bits) == value there
+	*/
+	template <typename Stencil>
+	unsigned long long stencilMask(const Stencil &stencil, unsigned int row, unsigned int column, const unsigned char* layer, unsigned char bits, unsigned char value);
+
+	/**Finds out which neighbors of a cell are occupied by the given type and not hidden by their terrain
+	\param stencil The neighbors to look at, as in stencilMask()
+	\param row The index of the row in the board buffer (the global row minus rowOffset)
+	\param column The column of the cell
+	\param type The type that is to be checked for in the neighboring locations
+	\param hidden The TerrainFlags that hide a neighbor. 0 if the terrain is not looked at
+	\return A neighbor mask with bit i set if neighbor i of the stencil matches
+	*/
+	template <typename Stencil>
+	unsigned long long visibleMask(const Stencil &stencil, unsigned int row, unsigned int column, BoardOccupantTypes type, unsigned char hidden);
+
+	/**Drops the part of a span of rows that lies above the first row stored in the board
+	\param firstRow The global index of the first row of the span. Raised to getRowOffset() if it is lower
+	\param numOfRectRows The number of rows in the span. Reduced by the number of rows dropped
+	*/
+	void clipToStrip(unsigned int &firstRow, unsigned int &numOfRectRows);
+
+	/**Feeds the current contents of the board to the trackers from scratch. Used when a tracker is enabled
+	*/
+	void rebuildTrackers();
 
 	/**
 		Constructor for SimulationBoard. Set to private to implement a singleton design pattern.
@@ -107,6 +198,13 @@ private:
 		\param numOfColumns The number of columns in the board
 	*/
 	SimulationBoard(unsigned int numOfRows, unsigned int numOfColumns);
+	/**
+		Constructor for a strip of a larger board. Set to private to implement a singleton design pattern.
+		\param firstRow The global index of the first row stored in the strip
+		\param numOfRows The number of rows stored in the strip
+		\param numOfColumns The number of columns in the board
+	*/
+	SimulationBoard(unsigned int firstRow, unsigned int numOfRows, unsigned int numOfColumns);
 	/**Default contructor for SimulationBoard. Not implemented and set to private to implement singleton design pattern
 	*/
 	SimulationBoard();
@@ -127,6 +225,27 @@ public:
 	*/
 	static SimulationBoard* get_instance(unsigned int numOfRows, unsigned int numOfColumns);
 
+	/**Creates a strip of a board that is split into horizontal strips, each owned by a separate process. The strip only stores the given
+	rows (the rows owned by the process plus its ghost rows) and keeps using global row indices, so agents are unaware of the split
+	\param firstRow The global index of the first row stored in the strip
+	\param numOfRows The number of rows stored in the strip
+	\param numOfColumns The number of columns in the board
+	\return A brand new board, to be deallocated by the caller
+	*/
+	static SimulationBoard* createStrip(unsigned int firstRow, unsigned int numOfRows, unsigned int numOfColumns);
+
+	/**Creates a board that is independent of the static instance. Used by programs that embed the simulator and run several
+	simulations in the same process
+	\param numOfRows The number of rows in the board
+	\param numOfColumns The number of columns in the board
+	\return A brand new board, to be deallocated by the caller
+	*/
+	static SimulationBoard* create(unsigned int numOfRows, unsigned int numOfColumns);
+
+	/**Destructor for SimulationBoard. Deallocates the trackers
+	*/
+	~SimulationBoard();
+
 	/**Adds an agent of the specified type to the SimulationBoard at the specified location
 	\param agentType The type of the agent to be added to the board
 	\param location The location to which the agent is to be added
@@ -150,30 +269,247 @@ public:
 	*/
 	bool outOfBounds(Coordinates location);
 
-	/**First, makes sure given location is not out of bounds and then checks to see if the given type resides in that location
+	/**First, makes sure given location is not out of bounds and then checks to see if the given type resides in that location, as seen
+	by an agent of the given type. Walls are never unoccupied
 	\param type The type that is to be checked for in the location
 	\param location The location in which the type to be checked
+	\param viewer The type of the agent looking: water is not unoccupied for roadrunners, and roadrunners in cover are hidden from
+	coyotes. unoccupied to only leave out walls
 	\return true If the location exists and the location is occupied by the given type, false otherwise
 	*/
-	bool existsHere(BoardOccupantTypes type, Coordinates location);
+	bool existsHere(BoardOccupantTypes type, Coordinates location, BoardOccupantTypes viewer = BoardOccupantTypes::unoccupied);
+
+	/**Finds out in one go which of the neighbors of the given location are occupied by the given type, as seen by an agent of the given
+	type. Locations outside the board never match. The neighbors are those of the neighborhood of the board, which is the von Neumann
+	neighborhood (up, down, left, right) unless setNeighborhood() has been called. With terrain, the mask is ANDed with a mask of the
+	neighbors whose terrain does not hide them, so the loops over the neighbors have no branches either way
+	\param location The location whose neighbors are checked. Must be inside the board
+	\param type The type that is to be checked for in the neighboring locations
+	\param viewer The type of the agent looking, as in existsHere()
+	\return A neighbor mask with bit i set if neighbor i of the neighborhood matches. In every neighborhood, bit 0 stands for the location
+	above, bit 1 for below, bit 2 for left and bit 3 for right
+	*/
+	unsigned long long neighborMask(Coordinates location, BoardOccupantTypes type, BoardOccupantTypes viewer = BoardOccupantTypes::unoccupied);
+
+	/**Checks if the terrain of a location lets an agent of the given type stand there: coyotes cannot stand on walls, and roadrunners
+	cannot stand on walls or in water
+	\param type coyote or roadrunner
+	\param location The location to check. Must be inside the board
+	\return True if the agent may stand there, whether or not the location is occupied
+	*/
+	bool canHold(BoardOccupantTypes type, Coordinates location);
+
+	/**Finds out which of the neighbors of the given location are closer to the nearest roadrunner than the location itself, with the
+	roadrunners where they stood at the last call to updatePursuit()
+	\param location The location whose neighbors are checked. Must be inside the board
+	\return A neighbor mask with bit i set if neighbor i of the neighborhood is closer. 0 if pursuit has not been enabled or no roadrunner
+	is in sight
+	*/
+	unsigned long long closerToPreyMask(Coordinates location);
+
+	/**Changes the neighborhood agents use to look around, move and breed
+	\param neighborhood The new neighborhood
+	*/
+	void setNeighborhood(const Neighborhood &neighborhood);
+
+	/**Returns the neighborhood agents use to look around, move and breed
+	\return The neighborhood
+	*/
+	const Neighborhood& getNeighborhood();
+
 	/**
-	Returns the total number of roadrunners currently residing in the board
+	Returns the total number of roadrunners currently residing in the board. The count is kept up to date on every change, so this takes
+	constant time
 	\return The total number of roadrunners in the board
 	*/
 	unsigned int numOfRoadRunners();
 
 	/**
-	Returns the total number of coyotes currently residing in the board
+	Returns the total number of coyotes currently residing in the board. The count is kept up to date on every change, so this takes
+	constant time
 	\return The total number of coyotes in the board
 	*/
 	unsigned int numOfCoyotes();
 
+	/**
+	Counts the agents of a species in a rectangle of the board. Uses the occupancy counts of the tiles of the board, so only the cells of
+	the tiles that straddle the border of the rectangle are looked at
+	\param type coyote or roadrunner
+	\param firstRow The global index of the first row of the rectangle
+	\param firstColumn The first column of the rectangle
+	\param numOfRectRows The number of rows in the rectangle. Clipped to the board
+	\param numOfRectColumns The number of columns in the rectangle. Clipped to the board
+	\return The number of agents of the species in the rectangle
+	*/
+	unsigned long populationInRect(BoardOccupantTypes type, unsigned int firstRow, unsigned int firstColumn, unsigned int numOfRectRows, unsigned int numOfRectColumns);
+
+	/**
+	Checks to see if a rectangle of the board holds no agents. Stops at the first agent found
+	\param firstRow The global index of the first row of the rectangle
+	\param firstColumn The first column of the rectangle
+	\param numOfRectRows The number of rows in the rectangle. Clipped to the board
+	\param numOfRectColumns The number of columns in the rectangle. Clipped to the board
+	\return True if no coyote or roadrunner resides in the rectangle
+	*/
+	bool isRegionEmpty(unsigned int firstRow, unsigned int firstColumn, unsigned int numOfRectRows, unsigned int numOfRectColumns);
+
+	/**
+	Finds the agent of a species nearest to a location, counting distance in steps up, down, left and right. Empty tiles of the board
+	are skipped, so the search does not scan the board cell by cell
+	\param type coyote or roadrunner
+	\param location The location searched from
+	\return The location of the nearest agent of the species, or uninitialized Coordinates if there is none
+	*/
+	Coordinates findNearest(BoardOccupantTypes type, Coordinates location);
+
+	/**
+	Returns the occupancy counts of the tiles of the board
+	\return The occupancy pyramid. Owned by the board
+	*/
+	OccupancyPyramid* getOccupancyPyramid();
+
+	/**
+	Returns the Zobrist hash of the contents of the board. The hash is updated on every change, so this takes constant time
+	\return The hash of the board
+	*/
+	unsigned long long getHash();
+
+	/**
+	Computes the Zobrist hash of some rows of the board, with the keys getHash() gives them on an unsplit board. Used to hash a board
+	that is split into strips one strip at a time. Reads every cell of the rows
+	\param firstRow The global index of the first row
+	\param numOfHashedRows The number of rows
+	\return The XOR of the keys of every occupied cell of the rows
+	*/
+	unsigned long long hashRows(unsigned int firstRow, unsigned int numOfHashedRows);
+
 	/**
 	Checks to see if the board is board is empty
 	\return True if board is empty, false otherwise
 	*/
 	bool boardIsEmpty();
 
+	/**
+	Returns the number of rows in the board
+	\return The number of rows
+	*/
+	unsigned int getNumOfRows();
+
+	/**
+	Returns the number of columns in the board
+	\return The number of columns
+	*/
+	unsigned int getNumOfColumns();
+
+	/**
+	Returns the global index of the first row stored in the board
+	\return 0, unless the board is a strip of a sharded board
+	*/
+	unsigned int getRowOffset();
+
+	/**
+	Copies the contents of one row of the board
+	\param row The global index of the row
+	\return The occupants of the row
+	*/
+	std::vector<BoardOccupantTypes> copyRow(unsigned int row);
+
+	/**
+	Overwrites the contents of one row of the board. Used to refresh the ghost rows of a strip
+	\param row The global index of the row
+	\param contents The new occupants of the row
+	*/
+	void overwriteRow(unsigned int row, const std::vector<BoardOccupantTypes> &contents);
+
+	/**
+	Returns a read-only pointer to the board buffer. Cell (row, column) is at index (row - getRowOffset()) * getRowStride() + column.
+	The pointer stays valid until the board is next changed
+	\return A pointer to the first cell of the board buffer
+	*/
+	const BoardOccupantTypes* getCells();
+
+	/**
+	Returns the distance between the first cells of two consecutive rows in the board buffer
+	\return The row stride, in cells
+	*/
+	unsigned long getRowStride();
+
+	/**
+	Prints one row of a board in the same format as printBoard()
+	\param row The occupants of the row
+	\param numOfColumns The number of cells in the row
+	*/
+	static void printRow(const BoardOccupantTypes* row, unsigned int numOfColumns);
+
+	/**Writes the new occupant of a cell into the back buffer, leaving the board unchanged until commitBackBuffer() is called. Allocates
+	the back buffer on first use. A cell written more than once keeps the last value
+	\param type The new occupant of the cell. unoccupied for a cell that an agent leaves
+	\param location The location of the cell
+	*/
+	void placeInBackBuffer(BoardOccupantTypes type, Coordinates location);
+
+	/**
+	Copies the cells written into the back buffer since the last call into the board, making them the current state of the board. The
+	cells go through the same path as every other change, so the trackers are updated incrementally, for the cells that changed only
+	*/
+	void commitBackBuffer();
+
+	/**
+	Starts keeping track of the clusters of each species. From then on, every change to the board updates the clusters incrementally
+	*/
+	void enableClusterTracking();
+
+	/**
+	Returns the cluster tracker
+	\return The cluster tracker, or NULL if cluster tracking has not been enabled
+	*/
+	ClusterTracker* getClusterTracker();
+
+	/**
+	Starts keeping the distance from every cell to the nearest roadrunner, for coyotes to pursue them. From then on, every change to the
+	board is recorded, and updatePursuit() repairs the distances around the cells that changed. Throws an invalid_argument exception if
+	the distance is invalid
+	\param maxDistance The distance beyond which coyotes do not see roadrunners
+	*/
+	void enablePursuit(unsigned int maxDistance);
+
+	/**
+	Brings the distance from every cell to the nearest roadrunner up to date with the changes made to the board since the last call.
+	Does nothing if pursuit has not been enabled
+	*/
+	void updatePursuit();
+
+	/**
+	Returns the distance from every cell to the nearest roadrunner
+	\return The prey distance field, or NULL if pursuit has not been enabled
+	*/
+	PreyDistanceField* getPreyDistanceField();
+
+	/**
+	Loads the static terrain of the board from a map file. Must be called before agents are placed on the board. Throws an
+	invalid_argument exception if the file cannot be read, is malformed or does not have the size of the board
+	\param fileName The name of the map file
+	*/
+	void loadTerrain(const char* fileName);
+
+	/**
+	Returns the static terrain of the board
+	\return The terrain map, or NULL if no terrain has been loaded
+	*/
+	TerrainMap* getTerrain();
+
+	/**
+	Returns the number of cells an agent of the given type may stand on
+	\param type coyote or roadrunner
+	\return The number of cells of the board, less the walls, and less the water for roadrunners
+	*/
+	unsigned long numOfHabitableCells(BoardOccupantTypes type);
+
+	/**
+	Prints the cluster statistics of both species. Prints nothing if cluster tracking has not been enabled
+	*/
+	void printStats();
+
 	/**
 	Prints the contents of the board
 	*/
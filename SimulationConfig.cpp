@@ -0,0 +1,208 @@
+#include "SimulationConfig.h"
+#include "PreyDistanceField.h"
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+unsigned int extractValueFromLine(string type, string line) {
+	unsigned int value;
+	//remove the name of the category from the line (for example, make the string "row: 45" into the string ": 45")
+	line = line.substr(type.length());
+	//remove extraneous white space and colon character that occur before value
+	while(line.length() != 0 && (line[0] == ':' || line[0] == ' ')) {
+		line = line.substr(1);
+	}
+	//if not value, throw exception
+	if(line.length() == 0) {
+		throw invalid_argument("bad argument");
+	}
+	try {
+		//extract value
+		value = stoul(line);
+	} catch (invalid_argument) {
+		throw invalid_argument("bad argument");
+	} catch (out_of_range) {
+		throw out_of_range("out of range");
+	}
+	return value;
+}
+
+string extractWordFromLine(string type, string line) {
+	line = line.substr(type.length());
+	//remove extraneous white space and colon character that occur before value
+	while(line.length() != 0 && (line[0] == ':' || line[0] == ' ')) {
+		line = line.substr(1);
+	}
+	//remove trailing white space
+	while(line.length() != 0 && (line[line.length() - 1] == ' ' || line[line.length() - 1] == '\r')) {
+		line = line.substr(0, line.length() - 1);
+	}
+	if(line.length() == 0) {
+		throw invalid_argument("bad argument");
+	}
+	return line;
+}
+
+bool parseConfigFile(const char* fileName, SimulationConfig &config) {
+	string fileContent = "";
+  string nextLine;
+  ifstream myFile(fileName);
+  if(myFile.is_open()) {
+    while(getline(myFile, nextLine)) {
+      if(nextLine == "") {
+				continue;
+			}
+			//check to see if a given line contains information for each attribute
+			if(nextLine.substr(0, 4) == "rows") {
+				try {
+					//extract value from line and assign to corresponding attribute
+					config.numOfRows = extractValueFromLine("rows", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid row value.");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid row value.");
+				}
+			} else if(nextLine.substr(0, 7) == "columns") {
+				try {
+					config.numOfColumns = extractValueFromLine("columns", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid column value.");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid column value.");
+				}
+			} else if(nextLine.substr(0, 11) == "roadrunners") {
+				try {
+					config.initialNumOfRoadrunners = extractValueFromLine("roadrunners", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid roadrunners value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid roadrunners value");
+				}
+			} else if(nextLine.substr(0, 7) == "coyotes") {
+				try {
+					config.initialNumOfCoyotes = extractValueFromLine("coyotes", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid coyote value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid coyote value");
+				}
+			} else if(nextLine.substr(0, 6) == "shards") {
+				try {
+					config.numOfShards = extractValueFromLine("shards", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid shards value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid shards value");
+				}
+			} else if(nextLine.substr(0, 8) == "clusters") {
+				try {
+					config.trackClusters = extractValueFromLine("clusters", nextLine) != 0;
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid clusters value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid clusters value");
+				}
+			} else if(nextLine.substr(0, 12) == "neighborhood") {
+				string shape;
+				try {
+					shape = extractWordFromLine("neighborhood", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid neighborhood value");
+				}
+				if(shape == "vonneumann") {
+					config.neighborhoodType = NeighborhoodTypes::vonNeumann;
+				} else if(shape == "moore") {
+					config.neighborhoodType = NeighborhoodTypes::moore;
+				} else if(shape.substr(0, 6) == "radius") {
+					config.neighborhoodType = NeighborhoodTypes::radius;
+					try {
+						config.neighborhoodRadius = extractValueFromLine("radius", shape);
+					} catch (invalid_argument) {
+						throw invalid_argument("Invalid neighborhood radius");
+					} catch (out_of_range) {
+						throw out_of_range("Invalid neighborhood radius");
+					}
+					if(config.neighborhoodRadius < 1 || config.neighborhoodRadius > Neighborhood::maxRadius) {
+						throw invalid_argument("Invalid neighborhood radius");
+					}
+				} else {
+					throw invalid_argument("Invalid neighborhood value");
+				}
+			} else if(nextLine.substr(0, 7) == "pursuit") {
+				try {
+					config.pursuitDistance = extractValueFromLine("pursuit", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid pursuit value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid pursuit value");
+				}
+				if(config.pursuitDistance > PreyDistanceField::maxMaxDistance) {
+					throw invalid_argument("Invalid pursuit value");
+				}
+			} else if(nextLine.substr(0, 8) == "viewrows") {
+				try {
+					config.numOfViewRows = extractValueFromLine("viewrows", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid viewrows value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid viewrows value");
+				}
+			} else if(nextLine.substr(0, 11) == "viewcolumns") {
+				try {
+					config.numOfViewColumns = extractValueFromLine("viewcolumns", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid viewcolumns value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid viewcolumns value");
+				}
+			} else if(nextLine.substr(0, 4) == "zoom") {
+				try {
+					config.zoom = extractValueFromLine("zoom", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid zoom value");
+				} catch (out_of_range) {
+					throw out_of_range("Invalid zoom value");
+				}
+				if(config.zoom == 0) {
+					throw invalid_argument("Invalid zoom value");
+				}
+			} else if(nextLine.substr(0, 6) == "layout") {
+				try {
+					config.layoutFileName = extractWordFromLine("layout", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid layout value");
+				}
+			} else if(nextLine.substr(0, 7) == "terrain") {
+				try {
+					config.terrainFileName = extractWordFromLine("terrain", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid terrain value");
+				}
+			} else if(nextLine.substr(0, 6) == "update") {
+				string mode;
+				try {
+					mode = extractWordFromLine("update", nextLine);
+				} catch (invalid_argument) {
+					throw invalid_argument("Invalid update value");
+				}
+				if(mode == "synchronous") {
+					config.synchronousUpdate = true;
+				} else if(mode == "sequential") {
+					config.synchronousUpdate = false;
+				} else {
+					throw invalid_argument("Invalid update value");
+				}
+			} else {
+				//if the line contains information irrelevant to any of the four attributes, declare file to be invalid and return false
+				cout << "Invalid file" << endl;
+				return false;
+			}
+    }
+    myFile.close();
+  } else {
+    return false;
+  }
+	return true;
+}
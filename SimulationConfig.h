@@ -0,0 +1,83 @@
+#pragma once
+#ifndef SIMULATIONCONFIG_H
+#define SIMULATIONCONFIG_H
+
+#include <string>
+#include "Neighborhood.h"
+
+
+/**
+	The settings of a simulation, as read from a config file. Every setting that is missing from the file keeps its default value
+*/
+struct SimulationConfig {
+	///The number of rows in the board
+	unsigned int numOfRows = 30;
+	///The number of columns in the board
+	unsigned int numOfColumns = 30;
+	///The initial number of roadrunners in the board
+	unsigned int initialNumOfRoadrunners = 50;
+	///The initial number of coyotes in the board
+	unsigned int initialNumOfCoyotes = 50;
+	///True for the synchronous update mode ("update: synchronous"), false for the default random-sequential mode
+	bool synchronousUpdate = false;
+	///The number of processes the board is split between ("shards: N")
+	unsigned int numOfShards = 1;
+	///True if cluster statistics are kept and printed ("clusters: 1")
+	bool trackClusters = false;
+	///The neighborhood agents look at, move to and breed into ("neighborhood: vonneumann", "neighborhood: moore" or
+	///"neighborhood: radius N")
+	NeighborhoodTypes neighborhoodType = NeighborhoodTypes::vonNeumann;
+	///The radius of the neighborhood, for the radius neighborhood
+	unsigned int neighborhoodRadius = 1;
+	///The distance within which coyotes see roadrunners and walk towards the nearest one ("pursuit: N"). 0 for the default random walk
+	unsigned int pursuitDistance = 0;
+	///The number of rows of glyphs printed when the board is shown ("viewrows: N"). 0 to show every row
+	unsigned int numOfViewRows = 0;
+	///The number of columns of glyphs printed when the board is shown ("viewcolumns: N"). 0 to show every column
+	unsigned int numOfViewColumns = 0;
+	///The number of rows and columns of cells each printed glyph stands for ("zoom: N")
+	unsigned int zoom = 1;
+	///The name of a map file holding the initial layout of the board ("layout: file"). Empty if the agents are placed at random. The
+	///layout sets the size of the board and the numbers of agents, overriding the rows, columns, roadrunners and coyotes settings
+	std::string layoutFileName;
+	///The name of a map file holding the static terrain of the board ("terrain: file"): walls, water and cover. Empty for open ground
+	///everywhere. The map must have the size of the board
+	std::string terrainFileName;
+	///True if the hash of the simulation state is printed after every time step ("--hash-trace" on the command line)
+	bool hashTrace = false;
+	///True if the simulation ends as soon as its state repeats an earlier time step ("--stop-on-repeat" on the command line)
+	bool stopOnRepeat = false;
+	///The name of a file the figures of every time step are published to, for monitors such as simtop ("--telemetry file" on the
+	///command line). Empty if nothing is published
+	std::string telemetryFileName;
+	///Where the board is written as a sequence of images ("--frames file" on the command line): a .png or .ppm file name, holding "%d"
+	///or "%0Nd" for one file per frame. Empty if no frames are written
+	std::string framesFileName;
+	///The number of time steps between two frames ("--frame-every N" on the command line)
+	unsigned long frameInterval = 1;
+	///The number of pixels on each side of the block drawn for a cell in the frames ("--frame-scale K" on the command line)
+	unsigned int frameScale = 1;
+};
+
+/**An implementation function used when parsing the config file. It takes a line from the file and extracts needed values
+from the line
+\param type The string representation of the category for which the function is extracting the value
+\param line The line from which the value is to be extracted
+*/
+unsigned int extractValueFromLine(std::string type, std::string line);
+
+/**An implementation function used when parsing the config file. It takes a line from the file and extracts a word value from the line
+\param type The string representation of the category for which the function is extracting the value
+\param line The line from which the value is to be extracted
+\return The extracted word
+*/
+std::string extractWordFromLine(std::string type, std::string line);
+
+/**A function used to parse the config file, extract required values, and assign them to the corresponding settings
+	\param fileName The name of the config file
+	\param config The settings to fill in. Settings missing from the file are left unchanged
+	\return true if parse was successful, false if unsuccessful
+*/
+bool parseConfigFile(const char* fileName, SimulationConfig &config);
+
+#endif
@@ -0,0 +1,142 @@
+#include "SocketCommunicator.h"
+#include <stdexcept>
+#include <iostream>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+/**Writes a whole buffer to a socket, retrying on short writes
+\param socket The socket to write to
+\param data The bytes to write
+\param length The number of bytes to write
+*/
+static void writeFully(int socket, const char* data, size_t length) {
+	while (length > 0) {
+		ssize_t written = write(socket, data, length);
+		if (written <= 0) {
+			throw std::runtime_error("Lost connection to another shard");
+		}
+		data += written;
+		length -= written;
+	}
+}
+
+/**Reads an exact number of bytes from a socket, retrying on short reads
+\param socket The socket to read from
+\param data The buffer to read into
+\param length The number of bytes to read
+*/
+static void readFully(int socket, char* data, size_t length) {
+	while (length > 0) {
+		ssize_t numRead = read(socket, data, length);
+		if (numRead <= 0) {
+			throw std::runtime_error("Lost connection to another shard");
+		}
+		data += numRead;
+		length -= numRead;
+	}
+}
+
+SocketCommunicator::SocketCommunicator(int processRank, const std::vector<int> &socketTo, const std::vector<pid_t> &children) {
+	this->processRank = processRank;
+	this->numOfProcesses = socketTo.size();
+	this->socketTo = socketTo;
+	this->children = children;
+}
+
+/**Closes every socket of a table of socket pairs that is still open
+\param sockets The table of sockets, with -1 for the entries that are not open
+*/
+static void closeSockets(std::vector<std::vector<int>> &sockets) {
+	for (unsigned int i = 0; i < sockets.size(); i++) {
+		for (unsigned int j = 0; j < sockets[i].size(); j++) {
+			if (sockets[i][j] != -1) {
+				close(sockets[i][j]);
+				sockets[i][j] = -1;
+			}
+		}
+	}
+}
+
+SocketCommunicator* SocketCommunicator::spawn(int numOfProcesses) {
+	//sockets[i][j] is the end of the socket pair between rank i and rank j that belongs to rank i
+	std::vector<std::vector<int>> sockets(numOfProcesses, std::vector<int>(numOfProcesses, -1));
+	for (int i = 0; i < numOfProcesses; i++) {
+		for (int j = i + 1; j < numOfProcesses; j++) {
+			int pair[2];
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+				closeSockets(sockets);
+				throw std::runtime_error("Could not create socket pair");
+			}
+			sockets[i][j] = pair[0];
+			sockets[j][i] = pair[1];
+		}
+	}
+
+	//flush pending output so that it is not duplicated in the children
+	std::cout.flush();
+	fflush(stdout);
+	std::vector<pid_t> children;
+	int processRank = 0;
+	for (int i = 1; i < numOfProcesses; i++) {
+		pid_t pid = fork();
+		if (pid < 0) {
+			//the children already started see their sockets close and give up, so they can be waited for
+			closeSockets(sockets);
+			for (unsigned int child = 0; child < children.size(); child++) {
+				waitpid(children[child], NULL, 0);
+			}
+			throw std::runtime_error("Could not fork shard process");
+		}
+		if (pid == 0) {
+			processRank = i;
+			children.clear();
+			break;
+		}
+		children.push_back(pid);
+	}
+
+	//close the ends of the socket pairs that belong to the other processes
+	for (int i = 0; i < numOfProcesses; i++) {
+		for (int j = 0; j < numOfProcesses; j++) {
+			if (i != processRank && sockets[i][j] != -1) {
+				close(sockets[i][j]);
+			}
+		}
+	}
+	return new SocketCommunicator(processRank, sockets[processRank], children);
+}
+
+SocketCommunicator::~SocketCommunicator() {
+	for (unsigned int i = 0; i < socketTo.size(); i++) {
+		if (socketTo[i] != -1) {
+			close(socketTo[i]);
+		}
+	}
+	for (unsigned int i = 0; i < children.size(); i++) {
+		waitpid(children[i], NULL, 0);
+	}
+}
+
+int SocketCommunicator::rank() {
+	return processRank;
+}
+
+int SocketCommunicator::size() {
+	return numOfProcesses;
+}
+
+void SocketCommunicator::send(int destination, const std::vector<char> &message) {
+	unsigned long length = message.size();
+	writeFully(socketTo[destination], (const char*)&length, sizeof(length));
+	writeFully(socketTo[destination], message.data(), length);
+}
+
+std::vector<char> SocketCommunicator::receive(int source) {
+	unsigned long length;
+	readFully(socketTo[source], (char*)&length, sizeof(length));
+	std::vector<char> message(length);
+	readFully(socketTo[source], message.data(), length);
+	return message;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef SOCKETCOMMUNICATOR_H
+#define SOCKETCOMMUNICATOR_H
+
+#include "Communicator.h"
+#include <vector>
+#include <sys/types.h>
+
+
+/**
+	A Communicator that runs every rank as a local process and passes messages over Unix domain sockets. Used to test the sharded
+	simulation on a single machine without a cluster.
+*/
+class SocketCommunicator : public Communicator {
+private:
+	///The rank of this process
+	int processRank;
+	///The number of processes
+	int numOfProcesses;
+	///socketTo[i] is the socket connected to the process of rank i. Unused (-1) for this process's own rank
+	std::vector<int> socketTo;
+	///The process ids of the child processes. Only filled in on rank 0
+	std::vector<pid_t> children;
+
+	/**
+		Constructor for the SocketCommunicator class. Set to private; instances are created by spawn()
+		\param processRank The rank of this process
+		\param socketTo The sockets connected to the other processes
+		\param children The process ids of the child processes, if this process is rank 0
+	*/
+	SocketCommunicator(int processRank, const std::vector<int> &socketTo, const std::vector<pid_t> &children);
+public:
+	/**Connects every pair of processes with a Unix domain socket pair and forks the calling process into numOfProcesses processes.
+	The calling process becomes rank 0. Throws a runtime_error exception if the sockets cannot be created or a process cannot be forked,
+	after closing the sockets and waiting for the processes already forked
+	\param numOfProcesses The number of processes to run
+	\return The communicator of the calling process (in the parent) or of the newly forked process (in each child)
+	*/
+	static SocketCommunicator* spawn(int numOfProcesses);
+
+	/**Closes the sockets. On rank 0, also waits for the child processes to exit
+	*/
+	~SocketCommunicator();
+
+	int rank();
+	int size();
+	void send(int destination, const std::vector<char> &message);
+	std::vector<char> receive(int source);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+/**
+	A fixed-capacity first-in first-out queue between exactly one producer thread and exactly one consumer thread. Neither side ever
+	takes a lock or waits: the producer only writes the tail index and the consumer only writes the head index, so checking an empty
+	queue costs one atomic load
+	\tparam T The type of the elements. Must be default-constructible and movable
+	\tparam capacity The number of slots in the queue. One slot is always left free to tell a full queue from an empty one
+*/
+template <typename T, size_t capacity>
+class SpscQueue {
+private:
+	///The slots of the queue
+	T slots[capacity];
+	///The index of the next slot to be read. Written by the consumer only
+	std::atomic<size_t> head;
+	///The index of the next slot to be written. Written by the producer only
+	std::atomic<size_t> tail;
+public:
+	/**Constructor for SpscQueue. The queue starts empty
+	*/
+	SpscQueue() : head(0), tail(0) {
+
+	}
+
+	/**Adds an element to the back of the queue. Must only be called from the producer thread
+	\param element The element to add
+	\return False if the queue is full, in which case the element is not added
+	*/
+	bool push(T element) {
+		size_t currentTail = tail.load(std::memory_order_relaxed);
+		size_t nextTail = (currentTail + 1) % capacity;
+		if (nextTail == head.load(std::memory_order_acquire)) {
+			return false;
+		}
+		slots[currentTail] = std::move(element);
+		//the release store publishes the element written into the slot to the consumer
+		tail.store(nextTail, std::memory_order_release);
+		return true;
+	}
+
+	/**Takes the element at the front of the queue. Must only be called from the consumer thread
+	\param element Set to the element taken
+	\return False if the queue is empty, in which case element is left unchanged
+	*/
+	bool pop(T &element) {
+		size_t currentHead = head.load(std::memory_order_relaxed);
+		if (currentHead == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		element = std::move(slots[currentHead]);
+		//the release store hands the slot back to the producer only once the element has been moved out of it
+		head.store((currentHead + 1) % capacity, std::memory_order_release);
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "StopCondition.h"
+
+StopCondition::StopCondition(StopConditionTypes type, unsigned long threshold, unsigned long numOfCoyotes, unsigned long numOfRoadrunners) {
+	this->type = type;
+	this->threshold = threshold;
+	unsigned long population = type == StopConditionTypes::coyoteThreshold ? numOfCoyotes : numOfRoadrunners;
+	startedBelow = population < threshold;
+	startedAtThreshold = population == threshold;
+	startTime = std::chrono::steady_clock::now();
+}
+
+bool StopCondition::isMet(unsigned long numOfCoyotes, unsigned long numOfRoadrunners, unsigned long numOfCells) {
+	switch (type) {
+	case StopConditionTypes::coyoteExtinction:
+		return numOfCoyotes == 0;
+	case StopConditionTypes::coyoteThreshold:
+		return hasCrossed(numOfCoyotes);
+	case StopConditionTypes::roadrunnerThreshold:
+		return hasCrossed(numOfRoadrunners);
+	case StopConditionTypes::boardFull:
+		return (numOfCoyotes + numOfRoadrunners) * 100 >= threshold * numOfCells;
+	case StopConditionTypes::wallClock:
+		return std::chrono::steady_clock::now() - startTime >= std::chrono::seconds(threshold);
+	}
+	return true;
+}
+
+bool StopCondition::hasCrossed(unsigned long population) {
+	if (startedAtThreshold) {
+		if (population == threshold) {
+			return false;
+		}
+		startedAtThreshold = false;
+		startedBelow = population < threshold;
+		return false;
+	}
+	return startedBelow ? population >= threshold : population <= threshold;
+}
+
+StopConditionTypes StopCondition::getType() {
+	return type;
+}
+
+unsigned long StopCondition::getThreshold() {
+	return threshold;
+}
+
+std::string StopCondition::describe() {
+	switch (type) {
+	case StopConditionTypes::coyoteExtinction:
+		return "the coyotes went extinct";
+	case StopConditionTypes::coyoteThreshold:
+		return "the number of coyotes crossed " + std::to_string(threshold);
+	case StopConditionTypes::roadrunnerThreshold:
+		return "the number of roadrunners crossed " + std::to_string(threshold);
+	case StopConditionTypes::boardFull:
+		return "the board is " + std::to_string(threshold) + "% full";
+	case StopConditionTypes::wallClock:
+		return std::to_string(threshold) + " seconds have passed";
+	}
+	return "";
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef STOPCONDITION_H
+#define STOPCONDITION_H
+
+#include <chrono>
+#include <string>
+
+
+/**
+	An enum class that describes the kinds of conditions a simulation can be run until.
+*/
+enum class StopConditionTypes {
+	coyoteExtinction, ///< stop when no coyotes are left
+	coyoteThreshold, ///< stop when the number of coyotes crosses the threshold, from either side (after first moving off it if it starts there)
+	roadrunnerThreshold, ///< stop when the number of roadrunners crosses the threshold, from either side (after first moving off it if it starts there)
+	boardFull, ///< stop when at least threshold percent of the board is occupied
+	wallClock ///< stop when threshold seconds of real time have passed
+};
+
+/**
+	A condition that ends a fast-forward through the simulation. It is checked once per time step against the population counts the
+	board keeps up to date, so checking it takes constant time no matter how large the board is.
+*/
+class StopCondition {
+private:
+	///The kind of condition
+	StopConditionTypes type;
+	///The population, percentage or number of seconds the condition compares against
+	unsigned long threshold;
+	///For the threshold conditions, true if the population started below the threshold (so it crosses by reaching it)
+	bool startedBelow;
+	///For the threshold conditions, true while the population has not moved off the threshold it started at
+	bool startedAtThreshold;
+	///The time at which the condition was created
+	std::chrono::steady_clock::time_point startTime;
+
+	/**Checks if a population has crossed the threshold. A population that started at the threshold must first move off it,
+	and then crosses it by coming back to it from that side
+	\param population The current population
+	\return True if the population has crossed the threshold
+	*/
+	bool hasCrossed(unsigned long population);
+public:
+	/**
+		The constructor for the StopCondition class
+		\param type The kind of condition
+		\param threshold The population, percentage or number of seconds to compare against. Ignored for coyoteExtinction
+		\param numOfCoyotes The number of coyotes when the condition is created
+		\param numOfRoadrunners The number of roadrunners when the condition is created
+	*/
+	StopCondition(StopConditionTypes type, unsigned long threshold, unsigned long numOfCoyotes, unsigned long numOfRoadrunners);
+
+	/**Checks if the condition is met
+	\param numOfCoyotes The current number of coyotes
+	\param numOfRoadrunners The current number of roadrunners
+	\param numOfCells The number of cells of the board that agents can stand on
+	\return True if the simulation should stop fast-forwarding
+	*/
+	bool isMet(unsigned long numOfCoyotes, unsigned long numOfRoadrunners, unsigned long numOfCells);
+
+	/**Returns the kind of condition
+	\return The kind of condition
+	*/
+	StopConditionTypes getType();
+
+	/**Returns the threshold of the condition
+	\return The population, percentage or number of seconds the condition compares against
+	*/
+	unsigned long getThreshold();
+
+	/**Describes the condition in words, to tell the user why the simulation stopped
+	\return The description
+	*/
+	std::string describe();
+};
+
+#endif
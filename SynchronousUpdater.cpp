@@ -0,0 +1,134 @@
+#include "SynchronousUpdater.h"
+#include "Hashing.h"
+#include <algorithm>
+#include <functional>
+
+const long SynchronousUpdater::minAgentsPerThread;
+
+SynchronousUpdater::SynchronousUpdater(SimulationBoard* board) {
+	this->board = board;
+	unsigned long numOfCells = (unsigned long)board->getNumOfRows() * board->getNumOfColumns();
+	occupantOf.assign(numOfCells, -1);
+	claimOf.assign(numOfCells, -1);
+	numOfPlanThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+unsigned long SynchronousUpdater::cellIndex(Coordinates location) {
+	return (unsigned long)location.getRow() * board->getNumOfColumns() + location.getColumn();
+}
+
+void SynchronousUpdater::claim(unsigned long cell, long agentIndex) {
+	long current = claimOf[cell];
+	if (current == -1) {
+		claimOf[cell] = agentIndex;
+		claimedCells.push_back(cell);
+	} else if (intents[agentIndex].priority > intents[current].priority ||
+		(intents[agentIndex].priority == intents[current].priority && agentIndex < current)) {
+		claimOf[cell] = agentIndex;
+	}
+}
+
+void SynchronousUpdater::clearClaims() {
+	for (unsigned long i = 0; i < claimedCells.size(); i++) {
+		claimOf[claimedCells[i]] = -1;
+	}
+	claimedCells.clear();
+}
+
+void SynchronousUpdater::planAgents(std::vector<Agent*> &agentList, long firstAgent, long endAgent) {
+	for (long i = firstAgent; i < endAgent; i++) {
+		agentList[i]->planStep(intents[i]);
+	}
+}
+
+void SynchronousUpdater::step(std::vector<Agent*> &agentList) {
+	long numOfAgents = agentList.size();
+	intents.assign(numOfAgents, AgentIntent());
+
+	//plan phase: every agent reads the previous-step board and writes only its own intent. The streams of the agents are derived from
+	//a single draw, so a run is still repeated by its seed
+	unsigned long long stepSeed = ((unsigned long long)rand() << 32) ^ rand();
+	for (long i = 0; i < numOfAgents; i++) {
+		intents[i].randomState = mixBits(stepSeed + i);
+		intents[i].priority = (unsigned int)(intents[i].randomState >> 32);
+		occupantOf[cellIndex(agentList[i]->getLocation())] = i;
+	}
+	//each thread plans a contiguous range of agents, and this thread plans the first one
+	long numOfThreads = std::min((long)numOfPlanThreads, std::max(1L, numOfAgents / minAgentsPerThread));
+	std::vector<std::thread> planThreads;
+	for (long thread = 1; thread < numOfThreads; thread++) {
+		planThreads.push_back(std::thread(&SynchronousUpdater::planAgents, this, std::ref(agentList), numOfAgents * thread / numOfThreads,
+			numOfAgents * (thread + 1) / numOfThreads));
+	}
+	planAgents(agentList, 0, numOfAgents / numOfThreads);
+	for (unsigned int i = 0; i < planThreads.size(); i++) {
+		planThreads[i].join();
+	}
+
+	//predation: of all coyotes chasing the same roadrunner, the one with the highest priority eats it. The others stay put
+	for (long i = 0; i < numOfAgents; i++) {
+		if (intents[i].eats) {
+			claim(cellIndex(intents[i].moveTo), i);
+		}
+	}
+	for (unsigned long i = 0; i < claimedCells.size(); i++) {
+		long winner = claimOf[claimedCells[i]];
+		intents[winner].moveGranted = true;
+		intents[occupantOf[claimedCells[i]]].eaten = true;
+	}
+	clearClaims();
+
+	//movement: every cell that was unoccupied in the previous time step goes to the highest-priority agent that wants to move there
+	for (long i = 0; i < numOfAgents; i++) {
+		AgentIntent &intent = intents[i];
+		if (intent.eats || intent.eaten || !intent.moveTo.initialized()) {
+			continue;
+		}
+		if (cellIndex(intent.moveTo) != cellIndex(agentList[i]->getLocation())) {
+			claim(cellIndex(intent.moveTo), i);
+		}
+	}
+	//the cells that agents move into stay claimed (marked with numOfAgents), so a birth only succeeds in a cell no agent has moved into
+	for (unsigned long i = 0; i < claimedCells.size(); i++) {
+		intents[claimOf[claimedCells[i]]].moveGranted = true;
+		claimOf[claimedCells[i]] = numOfAgents;
+	}
+
+	//births: of all agents that want to give birth in the same free cell, the one with the highest priority succeeds
+	unsigned long numOfMoveClaims = claimedCells.size();
+	for (long i = 0; i < numOfAgents; i++) {
+		if (!intents[i].eaten && intents[i].birthAt.initialized()) {
+			unsigned long cell = cellIndex(intents[i].birthAt);
+			if (claimOf[cell] != numOfAgents) {
+				claim(cell, i);
+			}
+		}
+	}
+	for (unsigned long i = numOfMoveClaims; i < claimedCells.size(); i++) {
+		intents[claimOf[claimedCells[i]]].birthGranted = true;
+	}
+	clearClaims();
+
+	//commit phase: agents update their own state, and the cells of the agents that move or die are emptied in the back buffer. The babies
+	//are appended to the list
+	for (long i = 0; i < numOfAgents; i++) {
+		Coordinates previousLocation = agentList[i]->getLocation();
+		occupantOf[cellIndex(previousLocation)] = -1;
+		Agent* baby = agentList[i]->commitStep(intents[i]);
+		if (intents[i].moveGranted || !agentList[i]->isAlive()) {
+			board->placeInBackBuffer(BoardOccupantTypes::unoccupied, previousLocation);
+		}
+		if (baby != NULL) {
+			agentList.push_back(baby);
+		}
+	}
+
+	//the cells entered are written after every cell left has been emptied, since an agent may enter the cell of an agent that moved away
+	//or was eaten
+	for (unsigned long i = 0; i < agentList.size(); i++) {
+		if (agentList[i]->isAlive() && ((long)i >= numOfAgents || intents[i].moveGranted)) {
+			board->placeInBackBuffer(agentList[i]->getType(), agentList[i]->getLocation());
+		}
+	}
+	board->commitBackBuffer();
+}
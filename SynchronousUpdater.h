@@ -0,0 +1,71 @@
+#pragma once
+#ifndef SYNCHRONOUSUPDATER_H
+#define SYNCHRONOUSUPDATER_H
+
+#include "Agent.h"
+#include <vector>
+#include <thread>
+
+
+/**
+	Runs time steps in the synchronous update mode. Unlike the default random-sequential mode, in which every act() immediately changes
+	the board, every agent first computes its intended move and birth against the read-only board of the previous time step. Each agent
+	draws from a random stream of its own, seeded from rand() once per time step, so the plans do not depend on each other: they are split
+	across threads when there are enough agents, and come out the same whatever the number of threads. Conflicts are then resolved deterministically using random priorities, and the cells that
+	change are written into the board's back buffer, which is committed to the board once every agent has been committed. Only the cells
+	that changed go through the board, so its trackers are updated incrementally.
+*/
+class SynchronousUpdater {
+private:
+	///The board on which the simulation is run
+	SimulationBoard* board;
+	///The intents of the agents for the current time step. intents[i] belongs to the i-th agent in the agent list
+	std::vector<AgentIntent> intents;
+	///For every cell, the index of the agent that occupied it in the previous time step, or -1
+	std::vector<long> occupantOf;
+	///For every cell, the index of the agent whose claim on it currently has the highest priority, or -1
+	std::vector<long> claimOf;
+	///The cells whose claimOf entry has been set during the current phase, so that they can be reset without scanning the board
+	std::vector<unsigned long> claimedCells;
+	///The most threads the plans are computed on
+	unsigned int numOfPlanThreads;
+	///The fewest agents a thread is started for, so that starting the threads does not cost more than it saves
+	static const long minAgentsPerThread = 4096;
+
+	/**Converts a location into an index in the cell vectors
+	\param location The location to convert
+	\return The row-major index of the location
+	*/
+	unsigned long cellIndex(Coordinates location);
+
+	/**Registers the claim of an agent on a cell. The claim with the highest priority wins; ties are broken by the lower agent index
+	\param cell The index of the claimed cell
+	\param agentIndex The index of the agent making the claim
+	*/
+	void claim(unsigned long cell, long agentIndex);
+
+	/**Resets every claim registered since the last call
+	*/
+	void clearClaims();
+
+	/**Computes the intents of a range of agents. Only reads the board, so several ranges can be planned at the same time
+	\param agentList The list of all agents in the simulation
+	\param firstAgent The index of the first agent of the range
+	\param endAgent The index one past the last agent of the range
+	*/
+	void planAgents(std::vector<Agent*> &agentList, long firstAgent, long endAgent);
+public:
+	/**
+		The constructor for the SynchronousUpdater class
+		\param board The board on which the simulation is run
+	*/
+	SynchronousUpdater(SimulationBoard* board);
+
+	/**Runs one synchronous time step. Dead agents are left in the list (marked as not alive) for the caller to clean up, and the
+		agents born during the step are appended to the end of the list
+	\param agentList The list of all agents in the simulation
+	*/
+	void step(std::vector<Agent*> &agentList);
+};
+
+#endif
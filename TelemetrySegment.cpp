@@ -0,0 +1,93 @@
+#include "TelemetrySegment.h"
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+const uint32_t TelemetrySegment::layoutMagic;
+const unsigned int TelemetrySegment::numOfSampleWords;
+
+TelemetrySegment::TelemetrySegment(const char* fileName, bool writable) {
+	this->writable = writable;
+	int fileDescriptor = writable ? open(fileName, O_RDWR | O_CREAT, 0644) : open(fileName, O_RDONLY);
+	if (fileDescriptor < 0) {
+		throw std::invalid_argument(std::string("Unable to open ") + fileName + ".");
+	}
+	struct stat fileStatus;
+	if (writable && ftruncate(fileDescriptor, sizeof(Layout)) != 0) {
+		close(fileDescriptor);
+		throw std::invalid_argument(std::string("Unable to resize ") + fileName + ".");
+	}
+	if (!writable && (fstat(fileDescriptor, &fileStatus) != 0 || (size_t)fileStatus.st_size < sizeof(Layout))) {
+		close(fileDescriptor);
+		throw std::invalid_argument(std::string(fileName) + " is not a telemetry file.");
+	}
+	//the mapping is shared, so that every sample the writer publishes is seen by the readers at once
+	void* mapping = mmap(NULL, sizeof(Layout), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	close(fileDescriptor);
+	if (mapping == MAP_FAILED) {
+		throw std::invalid_argument(std::string("Unable to map ") + fileName + " into memory.");
+	}
+	layout = (Layout*)mapping;
+
+	if (writable) {
+		//a reader that sees the file before the first sample finds the sequence at 0 and nothing to read
+		layout->magic = 0;
+		new (&layout->sequence) std::atomic<uint64_t>(0);
+		for (unsigned int i = 0; i < numOfSampleWords; i++) {
+			new (&layout->sampleWords[i]) std::atomic<uint64_t>(0);
+		}
+		layout->layoutSize = sizeof(Layout);
+		std::atomic_thread_fence(std::memory_order_release);
+		layout->magic = layoutMagic;
+	} else if (layout->magic != layoutMagic || layout->layoutSize != sizeof(Layout)) {
+		munmap(layout, sizeof(Layout));
+		throw std::invalid_argument(std::string(fileName) + " is not a telemetry file.");
+	}
+}
+
+TelemetrySegment::~TelemetrySegment() {
+	munmap(layout, sizeof(Layout));
+}
+
+void TelemetrySegment::publish(const TelemetrySample &sample) {
+	if (!writable) {
+		throw std::invalid_argument("The telemetry file was opened for reading only.");
+	}
+	uint64_t words[numOfSampleWords] = { 0 };
+	std::memcpy(words, &sample, sizeof(sample));
+	uint64_t sequence = layout->sequence.load(std::memory_order_relaxed);
+	layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+	//the odd sequence must be visible before any word of the sample changes
+	std::atomic_thread_fence(std::memory_order_release);
+	for (unsigned int i = 0; i < numOfSampleWords; i++) {
+		layout->sampleWords[i].store(words[i], std::memory_order_relaxed);
+	}
+	layout->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool TelemetrySegment::read(TelemetrySample &sample) {
+	uint64_t words[numOfSampleWords];
+	while (true) {
+		uint64_t before = layout->sequence.load(std::memory_order_acquire);
+		if (before == 0) {
+			return false;
+		}
+		if (before % 2 != 0) {
+			continue;
+		}
+		for (unsigned int i = 0; i < numOfSampleWords; i++) {
+			words[i] = layout->sampleWords[i].load(std::memory_order_relaxed);
+		}
+		//the copy must be complete before the sequence is checked again
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (layout->sequence.load(std::memory_order_relaxed) == before) {
+			std::memcpy(&sample, words, sizeof(sample));
+			return true;
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#ifndef TELEMETRYSEGMENT_H
+#define TELEMETRYSEGMENT_H
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+	The figures a running simulation publishes after every time step. Only fixed-size fields are used, so that the layout is the same in
+	every process that maps the segment
+*/
+struct TelemetrySample {
+	///The number of time steps run so far
+	uint64_t stepNumber;
+	///The number of roadrunners on the board
+	uint64_t numOfRoadrunners;
+	///The number of coyotes on the board
+	uint64_t numOfCoyotes;
+	///The number of agents born during the last time step
+	uint64_t numOfBirths;
+	///The number of agents that left the board during the last time step: starved coyotes and eaten roadrunners
+	uint64_t numOfDeaths;
+	///The number of roadrunners eaten during the last time step
+	uint64_t numOfKills;
+	///The number of time steps run per second, measured over the last half second or so
+	double stepsPerSecond;
+	///The time spent by the agents acting during the last time step, in nanoseconds
+	uint64_t actNanoseconds;
+	///The time spent removing dead agents during the last time step, in nanoseconds
+	uint64_t cleanupNanoseconds;
+	///The time spent hashing the state (for hash tracing and repeat detection) during the last time step, in nanoseconds
+	uint64_t hashNanoseconds;
+	///The number of rows in the board
+	uint32_t numOfRows;
+	///The number of columns in the board
+	uint32_t numOfColumns;
+	///1 once the simulation has ended, 0 while it is running
+	uint32_t finished;
+};
+
+/**
+	A small memory-mapped file through which a simulation publishes a TelemetrySample after every time step, for monitors in other
+	processes. The sample is guarded by a sequence counter (a seqlock): the writer makes the counter odd while it writes and even again
+	afterwards, and a reader retries if the counter was odd or changed while it copied the sample. The writer never waits for the readers
+	and neither side makes a system call per sample, so a monitor can poll at any rate without slowing the simulation down. A reader may
+	copy the sample while it is being written, so the sample is stored as 64-bit atomic words that both sides copy one by one with relaxed
+	loads and stores; the sequence counter alone decides whether the copy is kept
+*/
+class TelemetrySegment {
+private:
+	/**
+		The contents of the file
+	*/
+	struct Layout {
+		///Identifies the file as a telemetry segment of this layout
+		uint32_t magic;
+		///The size of the layout in bytes, so that a reader built with a different layout is refused
+		uint32_t layoutSize;
+		///Odd while the sample is being written. Incremented twice per sample
+		std::atomic<uint64_t> sequence;
+		///The bytes of the last sample published
+		std::atomic<uint64_t> sampleWords[(sizeof(TelemetrySample) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+	};
+
+	///The number of words the sample is stored in
+	static const unsigned int numOfSampleWords = sizeof(Layout::sampleWords) / sizeof(Layout::sampleWords[0]);
+
+	///The value of Layout::magic ("CRTM")
+	static const uint32_t layoutMagic = 0x4d545243;
+
+	///The mapped file
+	Layout* layout;
+	///True if the segment was opened for publishing
+	bool writable;
+
+	/**Copy contructor for TelemetrySegment. Not implemented, since two objects must not unmap the same memory
+	*/
+	TelemetrySegment(TelemetrySegment const&);
+	/**Overloaded assignment operator for TelemetrySegment. Not implemented, since two objects must not unmap the same memory
+	*/
+	TelemetrySegment& operator=(TelemetrySegment const&);
+public:
+	/**Maps a telemetry file into memory. Throws an invalid_argument exception if the file cannot be created, opened or mapped, or if a
+	file opened for reading is not a telemetry segment
+	\param fileName The name of the file
+	\param writable True to create (or reset) the file and publish samples to it, false to read the samples another process publishes
+	*/
+	TelemetrySegment(const char* fileName, bool writable);
+
+	/**Destructor for TelemetrySegment. Unmaps the file, which is left in place so that monitors can still read the last sample
+	*/
+	~TelemetrySegment();
+
+	/**Publishes a sample. Must only be called by one thread of one process. Throws an invalid_argument exception if the segment was opened
+	for reading
+	\param sample The sample
+	*/
+	void publish(const TelemetrySample &sample);
+
+	/**Reads the last sample published, retrying while the writer is in the middle of publishing one
+	\param sample Set to the sample
+	\return False if nothing has been published yet, in which case sample is left unchanged
+	*/
+	bool read(TelemetrySample &sample);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "TerrainMap.h"
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+const unsigned char TerrainFlags::wall;
+const unsigned char TerrainFlags::water;
+const unsigned char TerrainFlags::cover;
+const unsigned char TerrainFlags::all;
+
+const char TerrainMap::binaryMagic[4] = { 'C', 'R', 'T', 'N' };
+
+TerrainMap::TerrainMap(const char* fileName) : file(fileName) {
+	cells = NULL;
+	numOfRows = 0;
+	numOfColumns = 0;
+	numOfWalls = 0;
+	numOfWallsOrWater = 0;
+	if (file.getSize() >= sizeof(binaryMagic) && memcmp(file.getData(), binaryMagic, sizeof(binaryMagic)) == 0) {
+		uint32_t dimensions[2];
+		if (file.getSize() < sizeof(binaryMagic) + sizeof(dimensions)) {
+			throw std::invalid_argument("The terrain file is too short.");
+		}
+		memcpy(dimensions, file.getData() + sizeof(binaryMagic), sizeof(dimensions));
+		numOfRows = dimensions[0];
+		numOfColumns = dimensions[1];
+		if (file.getSize() != sizeof(binaryMagic) + sizeof(dimensions) + (unsigned long long)numOfRows * numOfColumns) {
+			throw std::invalid_argument("The size of the terrain file does not match its number of rows and columns.");
+		}
+		cells = (const unsigned char*)file.getData() + sizeof(binaryMagic) + sizeof(dimensions);
+		scanBinary();
+	} else {
+		parseAscii();
+		cells = parsedCells.data();
+	}
+	if (numOfRows == 0 || numOfColumns == 0) {
+		throw std::invalid_argument("The terrain file has no cells.");
+	}
+}
+
+void TerrainMap::parseAscii() {
+	const char* text = file.getData();
+	size_t size = file.getSize();
+	unsigned int column = 0;
+	for (size_t i = 0; i <= size; i++) {
+		//the end of the file ends the last row, even without a newline
+		char glyph = i < size ? text[i] : '\n';
+		unsigned char terrain;
+		switch (glyph) {
+		case '\n':
+			//blank lines do not count as rows
+			if (column == 0) {
+				continue;
+			}
+			if (numOfRows == 0) {
+				numOfColumns = column;
+			} else if (column != numOfColumns) {
+				throw std::invalid_argument("Row " + std::to_string(numOfRows + 1) + " of the terrain file has a different number of cells than the first row.");
+			}
+			numOfRows++;
+			column = 0;
+			continue;
+		case ' ':
+		case '\t':
+		case '\r':
+			continue;
+		case '.':
+			terrain = 0;
+			break;
+		case '#':
+			terrain = TerrainFlags::wall;
+			numOfWalls++;
+			numOfWallsOrWater++;
+			break;
+		case '~':
+			terrain = TerrainFlags::water;
+			numOfWallsOrWater++;
+			break;
+		case '*':
+			terrain = TerrainFlags::cover;
+			break;
+		default:
+			throw std::invalid_argument(std::string("Unknown character '") + glyph + "' in the terrain file.");
+		}
+		parsedCells.push_back(terrain);
+		column++;
+	}
+}
+
+void TerrainMap::scanBinary() {
+	unsigned long numOfCells = (unsigned long)numOfRows * numOfColumns;
+	for (unsigned long cell = 0; cell < numOfCells; cell++) {
+		if ((cells[cell] & ~TerrainFlags::all) != 0) {
+			throw std::invalid_argument("Unknown cell value " + std::to_string((int)cells[cell]) + " in the terrain file.");
+		}
+		numOfWalls += (cells[cell] & TerrainFlags::wall) != 0;
+		numOfWallsOrWater += (cells[cell] & (TerrainFlags::wall | TerrainFlags::water)) != 0;
+	}
+}
+
+const unsigned char* TerrainMap::getCells() {
+	return cells;
+}
+
+unsigned int TerrainMap::getNumOfRows() {
+	return numOfRows;
+}
+
+unsigned int TerrainMap::getNumOfColumns() {
+	return numOfColumns;
+}
+
+unsigned long TerrainMap::getNumOfWalls() {
+	return numOfWalls;
+}
+
+unsigned long TerrainMap::getNumOfWallsOrWater() {
+	return numOfWallsOrWater;
+}
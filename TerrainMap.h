@@ -0,0 +1,93 @@
+#pragma once
+#ifndef TERRAINMAP_H
+#define TERRAINMAP_H
+
+#include "MappedFile.h"
+#include <vector>
+
+
+/**
+	The bits that describe the terrain of a cell. A cell with none of them set is open ground
+*/
+struct TerrainFlags {
+	///No agent may enter the cell
+	static const unsigned char wall = 1;
+	///Roadrunners may not enter the cell. Coyotes may
+	static const unsigned char water = 2;
+	///A roadrunner in the cell is hidden from the coyotes around it
+	static const unsigned char cover = 4;
+	///All the bits that have a meaning
+	static const unsigned char all = wall | water | cover;
+};
+
+/**
+	The static terrain of a board, read from a map file: one byte of TerrainFlags per cell, row after row, kept apart from the occupants
+	of the board so that the queries on the board can AND their results against it. Two formats are accepted:
+	- ASCII: one line per row, with '.' for open ground, '#' for a wall, '~' for water and '*' for cover. Spaces between glyphs and blank
+	lines are ignored
+	- Binary: the four characters "CRTN", the number of rows and the number of columns as 32-bit unsigned integers in the byte order of
+	the machine, then one byte of TerrainFlags per cell, row after row
+	The file is mapped into memory rather than read. A binary map is used in place, without being copied, so the terrain of a large board
+	is only walked once to validate it and count its cells
+*/
+class TerrainMap {
+private:
+	///The contents of the map file
+	MappedFile file;
+	///The terrain of an ASCII map, converted to TerrainFlags. Empty for a binary map
+	std::vector<unsigned char> parsedCells;
+	///The terrain of every cell, in the mapped file or in parsedCells
+	const unsigned char* cells;
+	///The number of rows in the map
+	unsigned int numOfRows;
+	///The number of columns in the map
+	unsigned int numOfColumns;
+	///The number of cells that are walls
+	unsigned long numOfWalls;
+	///The number of cells that are walls or water
+	unsigned long numOfWallsOrWater;
+
+	/**Converts an ASCII map to TerrainFlags. Throws an invalid_argument exception if the map is malformed
+	*/
+	void parseAscii();
+
+	/**Checks the cells of a binary map and counts them. Throws an invalid_argument exception if a cell holds an unknown bit
+	*/
+	void scanBinary();
+public:
+	///The four characters a binary map file starts with
+	static const char binaryMagic[4];
+
+	/**Opens and validates a map file. Throws an invalid_argument exception if the file cannot be opened or is malformed
+	\param fileName The name of the map file
+	*/
+	TerrainMap(const char* fileName);
+
+	/**Returns the terrain of every cell. Cell (row, column) is at index row * getNumOfColumns() + column. The pointer stays valid as long
+	as the object exists
+	\return The TerrainFlags of the first cell
+	*/
+	const unsigned char* getCells();
+
+	/**Returns the number of rows in the map
+	\return The number of rows
+	*/
+	unsigned int getNumOfRows();
+
+	/**Returns the number of columns in the map
+	\return The number of columns
+	*/
+	unsigned int getNumOfColumns();
+
+	/**Returns the number of cells that are walls
+	\return The number of walls
+	*/
+	unsigned long getNumOfWalls();
+
+	/**Returns the number of cells that are walls or water
+	\return The number of cells roadrunners may not enter
+	*/
+	unsigned long getNumOfWallsOrWater();
+};
+
+#endif
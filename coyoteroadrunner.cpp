@@ -0,0 +1,52 @@
+#include "coyoteroadrunner.h"
+#include "Simulation.h"
+#include <exception>
+#include <memory>
+
+struct crs_simulation {
+	Simulation* simulation;
+};
+
+crs_simulation* crs_create(const char* config_path, unsigned int seed) {
+	SimulationConfig config;
+	try {
+		if (config_path != NULL && !parseConfigFile(config_path, config)) {
+			return NULL;
+		}
+		//the simulation is owned by the unique_ptr until the handle that takes it over exists
+		std::unique_ptr<Simulation> simulation(new Simulation(config, seed));
+		crs_simulation* handle = new crs_simulation;
+		handle->simulation = simulation.release();
+		return handle;
+	} catch (std::exception &e) {
+		return NULL;
+	}
+}
+
+void crs_destroy(crs_simulation* simulation) {
+	if (simulation != NULL) {
+		delete simulation->simulation;
+		delete simulation;
+	}
+}
+
+unsigned long crs_step(crs_simulation* simulation, unsigned long num_of_steps) {
+	return simulation->simulation->step(num_of_steps);
+}
+
+void crs_get_stats(crs_simulation* simulation, crs_stats* stats) {
+	SimulationStats simulationStats = simulation->simulation->getStats();
+	stats->step_number = simulationStats.stepNumber;
+	stats->num_of_roadrunners = simulationStats.numOfRoadrunners;
+	stats->num_of_coyotes = simulationStats.numOfCoyotes;
+	stats->finished = simulationStats.finished ? 1 : 0;
+}
+
+void crs_get_board_view(crs_simulation* simulation, crs_board_view* view) {
+	BoardView boardView = simulation->simulation->getBoardView();
+	//BoardOccupantTypes is stored as an unsigned char whose values match the CRS_ constants
+	view->cells = (const unsigned char*)boardView.cells;
+	view->num_of_rows = boardView.numOfRows;
+	view->num_of_columns = boardView.numOfColumns;
+	view->row_stride = boardView.rowStride;
+}
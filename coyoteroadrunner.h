@@ -0,0 +1,58 @@
+#ifndef COYOTEROADRUNNER_H
+#define COYOTEROADRUNNER_H
+
+/*
+	The C interface of the coyoteroadrunner library. Lets programs written in C, or in any language with a C foreign function interface,
+	run Coyote-Roadrunner simulations in-process. The C++ interface is the Simulation class in Simulation.h.
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The values stored in the cells of the board buffer */
+#define CRS_UNOCCUPIED 0
+#define CRS_COYOTE 1
+#define CRS_ROADRUNNER 2
+
+/* An opaque handle to a simulation */
+typedef struct crs_simulation crs_simulation;
+
+/* The population counts of a simulation at the end of a time step */
+typedef struct {
+	unsigned long step_number;
+	unsigned long num_of_roadrunners;
+	unsigned long num_of_coyotes;
+	int finished;
+} crs_stats;
+
+/* A read-only view of the board buffer. Cell (row, column) is at cells[row * row_stride + column] and holds one of the CRS_ values.
+   The view is not a copy: it stays valid until the simulation is next stepped or destroyed */
+typedef struct {
+	const unsigned char* cells;
+	unsigned int num_of_rows;
+	unsigned int num_of_columns;
+	unsigned long row_stride;
+} crs_board_view;
+
+/* Creates a simulation from a config file in the same format as the simulator's. If config_path is NULL, the default settings are used.
+   Returns NULL if the config file is invalid or cannot be opened */
+crs_simulation* crs_create(const char* config_path, unsigned int seed);
+
+/* Deallocates a simulation */
+void crs_destroy(crs_simulation* simulation);
+
+/* Runs up to num_of_steps time steps, stopping early if the simulation ends. Returns the number of time steps run */
+unsigned long crs_step(crs_simulation* simulation, unsigned long num_of_steps);
+
+/* Fills in the population counts of a simulation */
+void crs_get_stats(crs_simulation* simulation, crs_stats* stats);
+
+/* Fills in a read-only view of the board buffer of a simulation */
+void crs_get_board_view(crs_simulation* simulation, crs_board_view* view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
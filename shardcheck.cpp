@@ -0,0 +1,70 @@
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+#include "SocketCommunicator.h"
+#include "ShardedSimulation.h"
+#include "BoardRenderer.h"
+
+using namespace std;
+
+/**Runs a sharded simulation and records the hash of the whole board after the placement and after every time step
+\param numOfShards The number of strips
+\param numOfRows The number of rows in the board
+\param numOfColumns The number of columns in the board
+\param numOfRoadrunners The initial number of roadrunners
+\param numOfCoyotes The initial number of coyotes
+\param seed The seed shared by the strips
+\param numOfSteps The number of time steps to run
+\param numOfGhostRows The number of ghost rows stored on each side of a strip
+\return The hashes. The child processes exit instead of returning
+*/
+vector<unsigned long long> runShards(int numOfShards, unsigned int numOfRows, unsigned int numOfColumns, unsigned int numOfRoadrunners, unsigned int numOfCoyotes,
+	unsigned int seed, unsigned int numOfSteps, unsigned int numOfGhostRows) {
+	BoardRenderer renderer(0, 0, 1);
+	SocketCommunicator* communicator = SocketCommunicator::spawn(numOfShards);
+	vector<unsigned long long> hashes;
+	ShardedSimulation* simulation = new ShardedSimulation(communicator, numOfRows, numOfColumns, numOfRoadrunners, numOfCoyotes, seed, &renderer, numOfGhostRows);
+	hashes.push_back(simulation->hashBoard());
+	for (unsigned int i = 0; i < numOfSteps; i++) {
+		simulation->step();
+		hashes.push_back(simulation->hashBoard());
+	}
+	delete simulation;
+	bool child = communicator->rank() != 0;
+	delete communicator;
+	if (child) {
+		exit(0);
+	}
+	return hashes;
+}
+
+/**Checks that the ghost rows of the sharded simulation are enough for the agents next to the edge of a strip to decide as they would in
+a single process. Each board is run twice with two shards and the same seed: once with the ghost rows the simulator uses, and once with
+ghost rows covering the whole board, so that each strip sees the board exactly as a single process would. The hashes of the two runs
+must match after every time step
+*/
+int main(int argc, char** argv) {
+	unsigned int numOfSteps = argc > 1 ? strtoul(argv[1], NULL, 10) : 50;
+	//rows, columns, roadrunners, coyotes: a crowded board, a board in which the coyotes thrive, and a board whose strips are as thin as allowed
+	unsigned int boards[3][4] = { { 30, 30, 300, 60 }, { 40, 24, 150, 150 }, { 2 * 2 * ShardedSimulation::haloRows, 50, 200, 40 } };
+	int numOfFailures = 0;
+	for (unsigned int board = 0; board < 3; board++) {
+		for (unsigned int seed = 1; seed <= 4; seed++) {
+			unsigned int numOfRows = boards[board][0];
+			vector<unsigned long long> haloHashes = runShards(2, numOfRows, boards[board][1], boards[board][2], boards[board][3], seed, numOfSteps, ShardedSimulation::haloRows);
+			vector<unsigned long long> wholeHashes = runShards(2, numOfRows, boards[board][1], boards[board][2], boards[board][3], seed, numOfSteps, numOfRows);
+			unsigned int step = 0;
+			while (step < haloHashes.size() && haloHashes[step] == wholeHashes[step]) {
+				step++;
+			}
+			cout << numOfRows << "x" << boards[board][1] << " board, seed " << seed << ": ";
+			if (step == haloHashes.size()) {
+				cout << "identical for " << numOfSteps << " time steps" << endl;
+			} else {
+				cout << "FAILED, the boards differ after time step " << step << endl;
+				numOfFailures++;
+			}
+		}
+	}
+	return numOfFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <exception>
+#include "TelemetrySegment.h"
+
+using namespace std;
+
+/**Prints one sample of a running simulation, after clearing the terminal
+\param sample The sample
+\param fileName The name of the telemetry file it was read from
+*/
+void printSample(const TelemetrySample &sample, const char* fileName) {
+	//move the cursor to the top left corner and clear the screen, so that the figures are redrawn in place
+	cout << "\033[H\033[2J";
+	cout << "simtop - " << fileName << (sample.finished ? " (ended)" : "") << endl << endl;
+	cout << "Board:          " << sample.numOfRows << " x " << sample.numOfColumns << endl;
+	cout << "Time step:      " << sample.stepNumber << endl;
+	cout << "Steps/second:   " << fixed << setprecision(1) << sample.stepsPerSecond << endl;
+	cout << "Roadrunners:    " << sample.numOfRoadrunners << endl;
+	cout << "Coyotes:        " << sample.numOfCoyotes << endl << endl;
+	cout << "Last time step" << endl;
+	cout << "  Births:       " << sample.numOfBirths << endl;
+	cout << "  Deaths:       " << sample.numOfDeaths << endl;
+	cout << "  Kills:        " << sample.numOfKills << endl;
+	cout << "  Acting:       " << setprecision(3) << sample.actNanoseconds / 1e6 << " ms" << endl;
+	cout << "  Cleanup:      " << sample.cleanupNanoseconds / 1e6 << " ms" << endl;
+	cout << "  Hashing:      " << sample.hashNanoseconds / 1e6 << " ms" << endl;
+}
+
+/**Shows the figures a simulator started with --telemetry FILE publishes, refreshed a few times per second, until the simulation ends
+*/
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		cout << "Usage: simtop TELEMETRYFILE [REFRESHMILLISECONDS]" << endl;
+		return 0;
+	}
+	unsigned long refreshMilliseconds = argc > 2 ? strtoul(argv[2], NULL, 10) : 250;
+	try {
+		TelemetrySegment segment(argv[1], false);
+		TelemetrySample sample;
+		while (true) {
+			//reading the sample is a few loads from the mapped file, so polling never slows the simulation down
+			if (segment.read(sample)) {
+				printSample(sample, argv[1]);
+				if (sample.finished) {
+					break;
+				}
+			}
+			this_thread::sleep_for(chrono::milliseconds(refreshMilliseconds));
+		}
+	} catch (exception &e) {
+		cout << e.what() << endl;
+	}
+	return 0;
+}
@@ -2,51 +2,32 @@
 #include <vector>
 #include <algorithm>
 #include <stdlib.h>
+#include <stdio.h>
 #include <time.h>
 #include "Roadrunner.h"
 #include "Coyote.h"
 #include "SimulationBoard.h"
+#include "Simulation.h"
+#include "SimulationConfig.h"
+#include "SocketCommunicator.h"
+#include "ShardedSimulation.h"
+#include "StopCondition.h"
+#include "ControlChannel.h"
+#include "BoardRenderer.h"
+#include "EnsembleRunner.h"
 #include <fstream>
 #include <string>
 #include <limits>
 #include <climits>
 #include <stdexcept>
 #include <exception>
+#include <functional>
+#include <sstream>
+#include <chrono>
+#include <thread>
 
 using namespace std;
 
-/**returns a random value to use in std::random_shuffle()
-*/
-int myRandom(int i) {
-	return std::rand() % i;
-}
-
-/**
-	Shuffles the order of the agents in a specified portion of the agentList vector
-	\param agentList The vector to shuffle
-	\param indexToStartShuffleFrom The index of the vector after which the vector is shuffled. All elements of the vector before this index remain unchanged
-*/
-void shuffleAgents(vector<Agent*> &agentList, unsigned int indexToStartShuffleFrom) {
-	std::random_shuffle(agentList.begin() + indexToStartShuffleFrom, agentList.end(), myRandom);
-}
-
-/**Goes through the agentList vector and looks at each agent to see which one is marked dead. If the agent is marked dead, then it
-	removes the agent from the vector. Deallocates all pointers of the dead agents as well
-	\param agentList the vector that is to be cleaned up
-*/
-void cleanAgentList(vector<Agent*> &agentList) {
-	vector<Agent*> tempVector = agentList;
-	agentList.clear();
-	for (unsigned int i = 0; i < tempVector.size(); i++) {
-		if (!(tempVector[i]->isAlive())) {
-			delete tempVector[i];
-		}
-		else {
-			agentList.push_back(tempVector[i]);
-		}
-	}
-}
-
 /**Prints the menu for the options available to the user of the simulation
 */
 
@@ -60,11 +41,60 @@ void printOptions() {
 	cout << "		(5) Skip 50 time steps:" << endl;
 	cout << "		(6) Skip 100 time steps:" << endl;
 	cout << "		(7) Skip 500 time steps:" << endl;
+	cout << "		(8) Run until a condition is met:" << endl;
 	cout << "		(-) Enter any other character to end the simulation: " << endl;
 	cout << endl;
 }
 
 
+/**Prints the menu options for moving the window of the board, shown when the board is printed through a window
+*/
+void printViewOptions() {
+	cout << "		(w/a/s/d) Move the window up/left/down/right:" << endl;
+	cout << "		(i/o) Zoom in/out:" << endl;
+	cout << endl;
+}
+
+
+/**Applies a window menu option
+	\param prompt The user's chosen menu option
+	\param renderer The window of the board
+	\return True if the option was a window option, false otherwise
+*/
+bool viewLogic(char prompt, BoardRenderer &renderer) {
+	if(prompt == 'w') {
+		renderer.pan(-1, 0);
+	} else if(prompt == 's') {
+		renderer.pan(1, 0);
+	} else if(prompt == 'a') {
+		renderer.pan(0, -1);
+	} else if(prompt == 'd') {
+		renderer.pan(0, 1);
+	} else if(prompt == 'i') {
+		renderer.setZoom(renderer.getZoom() / 2);
+	} else if(prompt == 'o') {
+		renderer.setZoom(renderer.getZoom() * 2);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+
+/**Prints the board, through a window if there is one, followed by its stats
+	\param board The board
+	\param renderer The window of the board, or NULL to print the whole board
+*/
+void showBoard(SimulationBoard* board, BoardRenderer* renderer) {
+	if(renderer != NULL) {
+		renderer->render(board);
+	} else {
+		board->printBoard();
+	}
+	board->printStats();
+}
+
+
 /**An implementation function that read's the user's input and produces a value to change the logic accordingly
 	\param prompt The user's chosen menu option
 	\return The timeStepsCountdown value corresponding to the chosen option
@@ -84,121 +114,209 @@ int menuLogic(char prompt) {
 		return 100;
 	} else if(prompt == '7') {
 		return 500;
+	} else if(prompt == '8') {
+		//the board is not printed on a countdown while running until a condition is met
+		return INT_MAX;
 	} else {
 		return -2;
 	}
 }
 
 
-/**An implementation function used when parsing the config file. It takes a line from the file and extracts needed values
-from the line
-\param type The string representation of the category for which the function is extracting the value
-\param line The line from which the value is to be extracted
+/**Prints the conditions the user can run the simulation until, and reads the user's choice
+	\param numOfCoyotes The current number of coyotes
+	\param numOfRoadrunners The current number of roadrunners
+	\return The chosen condition, or NULL if the user entered an invalid choice
 */
-unsigned int extractValueFromLine(string type, string line) {
-	unsigned int value;
-	//remove the name of the category from the line (for example, make the string "row: 45" into the string ": 45")
-	line = line.substr(type.length());
-	//remove extraneous white space and colon character that occur before value
-	while(line.length() != 0 && (line[0] == ':' || line[0] == ' ')) {
-		line = line.substr(1);
+StopCondition* readStopCondition(unsigned long numOfCoyotes, unsigned long numOfRoadrunners) {
+	char prompt;
+	unsigned long threshold = 0;
+	cout << endl;
+	cout << "Run until:" << endl;
+	cout << "		(a) The coyotes go extinct:" << endl;
+	cout << "		(b) The number of coyotes crosses a threshold:" << endl;
+	cout << "		(c) The number of roadrunners crosses a threshold:" << endl;
+	cout << "		(d) A percentage of the board is full:" << endl;
+	cout << "		(e) A number of seconds has passed:" << endl;
+	cout << endl;
+	cin >> prompt;
+	if(prompt == 'a') {
+		return new StopCondition(StopConditionTypes::coyoteExtinction, 0, numOfCoyotes, numOfRoadrunners);
 	}
-	//if not value, throw exception
-	if(line.length() == 0) {
-		throw invalid_argument("bad argument");
+	if(prompt < 'b' || prompt > 'e') {
+		return NULL;
 	}
-	try {
-		//extract value
-		value = stoul(line);
-	} catch (invalid_argument) {
-		throw invalid_argument("bad argument");
-	} catch (out_of_range) {
-		throw out_of_range("out of range");
+	cout << "Enter the threshold:" << endl;
+	if(!(cin >> threshold)) {
+		return NULL;
 	}
-	return value;
+	StopConditionTypes types[4] = { StopConditionTypes::coyoteThreshold, StopConditionTypes::roadrunnerThreshold, StopConditionTypes::boardFull, StopConditionTypes::wallClock };
+	return new StopCondition(types[prompt - 'b'], threshold, numOfCoyotes, numOfRoadrunners);
 }
 
-/**A function used to parse the config file, extract required values, and assign them to corresponding variables
-	\param argv The command line argument containing the name of the file
-	\param numOfRows The number of rows in the Simulation Board
-	\param numOfColumns The number of columns in the Simulation Board
-	\param initialNumOfRoadrunners The initial number of roadrunners in the Simulation Board
-	\param initialNumOfCoyotes The initial number of coyotes in the Simulation Board
-	\return true if parse was successful, false if unsuccessful
+
+/**Runs the simulation at full speed, without the menu, applying the commands read by the control channel between time steps
+	\param simulation The simulation to run
+	\param channel The channel the commands are read from
+	\param renderer The window through which the board is printed
+	\param hashTrace True if the state hash is printed after every time step
 */
-bool parseFile(char** argv, unsigned int &numOfRows, unsigned int &numOfColumns, unsigned int &initialNumOfRoadrunners, unsigned int &initialNumOfCoyotes) {
-	string fileContent = "";
-  string nextLine;
-  ifstream myFile(argv[1]);
-  if(myFile.is_open()) {
-    while(getline(myFile, nextLine)) {
-      if(nextLine == "") {
-				continue;
-			}
-			//check to see if a given line contains information for each attribute
-			if(nextLine.substr(0, 4) == "rows") {
-				try {
-					//extract value from line and assign to corresponding attribute
-					numOfRows = extractValueFromLine("rows", nextLine);
-				} catch (invalid_argument) {
-					throw invalid_argument("Invalid row value.");
-				} catch (out_of_range) {
-					throw out_of_range("Invalid row value.");
-				}
-			} else if(nextLine.substr(0, 7) == "columns") {
-				try {
-					numOfColumns = extractValueFromLine("columns", nextLine);
-				} catch (invalid_argument) {
-					throw invalid_argument("Invalid column value.");
-				} catch (out_of_range) {
-					throw out_of_range("Invalid column value.");
-				}
-			} else if(nextLine.substr(0, 11) == "roadrunners") {
-				try {
-					initialNumOfRoadrunners = extractValueFromLine("roadrunners", nextLine);
-				} catch (invalid_argument) {
-					throw invalid_argument("Invalid roadrunners value");
-				} catch (out_of_range) {
-					throw out_of_range("Invalid roadrunners value");
-				}
-			} else if(nextLine.substr(0, 7) == "coyotes") {
+void runControlled(Simulation &simulation, ControlChannel &channel, BoardRenderer &renderer, bool hashTrace) {
+	bool paused = false;
+	//the number of time steps left to run before pausing again, after a step command
+	unsigned long stepsLeft = 0;
+	unsigned int stepClient = ControlChannel::stdinClient;
+	//the board is printed every renderRate time steps. 0 means never
+	unsigned long renderRate = 0;
+	ControlCommand command;
+	//a step command that is cut short by another command, or by the end of the simulation, still gets its reply
+	std::function<void(const char*)> endStep = [&](const char* verb) {
+		if(stepsLeft > 0) {
+			ostringstream reply;
+			reply << verb << " at time step " << simulation.getStats().stepNumber << "." << endl;
+			channel.reply(stepClient, reply.str());
+			stepsLeft = 0;
+		}
+	};
+
+	cout << "Running. Commands: pause, resume, step [N], rate N, stats, checkpoint FILE, view ROW COLUMN, zoom K, quit" << endl;
+	while(!simulation.finished()) {
+		while(channel.nextCommand(command)) {
+			ostringstream reply;
+			SimulationStats stats = simulation.getStats();
+			switch(command.type) {
+			case ControlCommandTypes::pause:
+				paused = true;
+				endStep("Paused");
+				reply << "Paused at time step " << stats.stepNumber << "." << endl;
+				break;
+			case ControlCommandTypes::resume:
+				paused = false;
+				endStep("Resumed");
+				reply << "Resumed at time step " << stats.stepNumber << "." << endl;
+				break;
+			case ControlCommandTypes::step:
+				paused = true;
+				endStep("Paused");
+				stepsLeft = command.argument;
+				stepClient = command.clientId;
+				break;
+			case ControlCommandTypes::rate:
+				renderRate = command.argument;
+				break;
+			case ControlCommandTypes::stats:
+				reply << "Time step " << stats.stepNumber << ": " << stats.numOfRoadrunners << " roadrunners, " << stats.numOfCoyotes << " coyotes. Last time step: "
+					<< stats.numOfBirths << " births, " << stats.numOfDeaths << " deaths, " << stats.numOfKills << " kills." << endl;
+				break;
+			case ControlCommandTypes::checkpoint:
 				try {
-					initialNumOfCoyotes = extractValueFromLine("coyotes", nextLine);
-				} catch (invalid_argument) {
-					throw invalid_argument("Invalid coyote value");
-				} catch (out_of_range) {
-					throw out_of_range("Invalid coyote value");
+					simulation.saveCheckpoint(command.fileName.c_str());
+					reply << "Saved time step " << stats.stepNumber << " to " << command.fileName << "." << endl;
+				} catch(invalid_argument &e) {
+					reply << e.what() << endl;
 				}
-			} else {
-				//if the line contains information irrelevant to any of the four attributes, declare file to be invalid and return false
-				cout << "Invalid file" << endl;
-				return false;
+				break;
+			case ControlCommandTypes::view:
+				renderer.setOrigin(command.argument, command.secondArgument);
+				showBoard(simulation.getBoard(), &renderer);
+				break;
+			case ControlCommandTypes::zoom:
+				renderer.setZoom(command.argument);
+				showBoard(simulation.getBoard(), &renderer);
+				break;
+			case ControlCommandTypes::quit:
+				endStep("Quitting");
+				channel.reply(command.clientId, "Quitting.\n");
+				return;
 			}
-    }
-    myFile.close();
-  } else {
-    return false;
-  }
-	return true;
-}
+			if(!reply.str().empty()) {
+				channel.reply(command.clientId, reply.str());
+			}
+		}
 
+		if(paused && stepsLeft == 0) {
+			//nothing to run until the next command arrives
+			this_thread::sleep_for(chrono::milliseconds(1));
+			continue;
+		}
+		simulation.step(std::function<void()>());
+		SimulationStats stats = simulation.getStats();
+		if(hashTrace) {
+			fprintf(stderr, "%lu %016llx\n", stats.stepNumber, simulation.getStateHash());
+		}
+		if(renderRate != 0 && stats.stepNumber % renderRate == 0) {
+			showBoard(simulation.getBoard(), &renderer);
+		}
+		if(stepsLeft > 0 && --stepsLeft == 0) {
+			ostringstream reply;
+			reply << "Paused at time step " << stats.stepNumber << "." << endl;
+			channel.reply(stepClient, reply.str());
+		}
+	}
+	endStep("Simulation ended");
+	cout << "Simulation ended at time step " << simulation.getStats().stepNumber << "." << endl;
+}
 
 
 int main(int argc, char** argv) {
-	unsigned int numOfRows;
-	unsigned int numOfColumns;
-	unsigned int initialNumOfRoadrunners;
-	unsigned int initialNumOfCoyotes;
+	SimulationConfig config;
+	const char* configFileName = NULL;
+	unsigned int seed = time(NULL);
+	bool controlFromStdin = false;
+	string controlSocketPath;
+	const char* checkpointFileName = NULL;
+	string ensembleMetric;
+	unsigned long ensembleHorizon = 1000;
+	double ensemblePrecision = 0;
+	unsigned long maxReplicas = 10000;
+	unsigned int numOfJobs = thread::hardware_concurrency();
 
-	if(argc <= 1) {
+	//options start with "--". The first other argument is the config file
+	for(int i = 1; i < argc; i++) {
+		string argument = argv[i];
+		if(argument == "--hash-trace") {
+			config.hashTrace = true;
+		} else if(argument == "--stop-on-repeat") {
+			config.stopOnRepeat = true;
+		} else if(argument == "--seed" && i + 1 < argc) {
+			seed = strtoul(argv[++i], NULL, 10);
+		} else if(argument == "--control") {
+			controlFromStdin = true;
+		} else if(argument == "--control-socket" && i + 1 < argc) {
+			controlSocketPath = argv[++i];
+		} else if(argument == "--restore" && i + 1 < argc) {
+			checkpointFileName = argv[++i];
+		} else if(argument == "--telemetry" && i + 1 < argc) {
+			config.telemetryFileName = argv[++i];
+		} else if(argument == "--frames" && i + 1 < argc) {
+			config.framesFileName = argv[++i];
+		} else if(argument == "--frame-every" && i + 1 < argc) {
+			config.frameInterval = strtoul(argv[++i], NULL, 10);
+		} else if(argument == "--frame-scale" && i + 1 < argc) {
+			config.frameScale = strtoul(argv[++i], NULL, 10);
+		} else if(argument == "--ensemble" && i + 1 < argc) {
+			ensembleMetric = argv[++i];
+		} else if(argument == "--horizon" && i + 1 < argc) {
+			ensembleHorizon = strtoul(argv[++i], NULL, 10);
+		} else if(argument == "--precision" && i + 1 < argc) {
+			ensemblePrecision = strtod(argv[++i], NULL);
+		} else if(argument == "--max-replicas" && i + 1 < argc) {
+			maxReplicas = strtoul(argv[++i], NULL, 10);
+		} else if(argument == "--jobs" && i + 1 < argc) {
+			numOfJobs = strtoul(argv[++i], NULL, 10);
+		} else if(argument.substr(0, 2) == "--") {
+			cout << "Unknown option " << argument << ". Aborting." << endl;
+			return 0;
+		} else if(configFileName == NULL) {
+			configFileName = argv[i];
+		}
+	}
+
+	if(configFileName == NULL) {
   	cout << "File name missing. Assigning default values" << endl;
-		numOfRows = 30;
-		numOfColumns = 30;
-		initialNumOfRoadrunners = 50;
-		initialNumOfCoyotes = 50;
   } else {
 		try {
-			if(!parseFile(argv, numOfRows, numOfColumns, initialNumOfRoadrunners, initialNumOfCoyotes)) {
+			if(!parseConfigFile(configFileName, config)) {
 				cout << "File is invalid or not able to be opened. Aborting." << endl;
 				return 0;
 			}
@@ -214,80 +332,250 @@ int main(int argc, char** argv) {
 		}
 	}
 
-	//check to see if the roadrunners and coyotes can fit in the board
-	if(initialNumOfCoyotes + initialNumOfRoadrunners > numOfRows * numOfColumns) {
+	//check to see if the roadrunners and coyotes can fit in the board. With a layout file, the simulation checks the layout instead
+	if(config.layoutFileName.empty() && config.initialNumOfCoyotes + config.initialNumOfRoadrunners > config.numOfRows * config.numOfColumns) {
 		cout << "Too many roadrunners and coyotes to fit in the board." << endl;
 		return 0;
 	}
 
-	vector<Agent*> agentList;
-	SimulationBoard* myBoard = SimulationBoard::get_instance(numOfRows, numOfColumns);
-	Coordinates tempLocation;
-	unsigned int randomNum;
-	srand(time(NULL));
-
-	//add roadrunners to the agentList vector in random unoccupied locations
-	for (int i = 0; i < initialNumOfRoadrunners; i++) {
-		do {
-			tempLocation.setCoordinates(rand() % numOfRows, rand() % numOfColumns);
-		} while (!myBoard->existsHere(BoardOccupantTypes::unoccupied, tempLocation));
-		agentList.push_back(new Roadrunner(myBoard, tempLocation));
+	if(config.numOfShards > 1) {
+		//every replica of an ensemble is a whole simulation of its own
+		if(!ensembleMetric.empty()) {
+			cout << "An ensemble cannot be combined with shards." << endl;
+			return 0;
+		}
+		//each strip must be at least two halos high, so that the two neighbors of a strip can never reach the same cell
+		if(config.synchronousUpdate) {
+			cout << "The synchronous update mode cannot be combined with shards." << endl;
+			return 0;
+		}
+		if(!config.layoutFileName.empty()) {
+			cout << "A layout file cannot be combined with shards." << endl;
+			return 0;
+		}
+		//the ghost rows of a strip only cover the reach of the von Neumann neighborhood
+		if(config.neighborhoodType != NeighborhoodTypes::vonNeumann) {
+			cout << "Only the von Neumann neighborhood can be combined with shards." << endl;
+			return 0;
+		}
+		//the frames are drawn from the board of a single simulation
+		if(!config.framesFileName.empty()) {
+			cout << "Frames cannot be written with shards." << endl;
+			return 0;
+		}
+		//the terrain is loaded by the simulation of a whole board
+		if(!config.terrainFileName.empty()) {
+			cout << "A terrain file cannot be combined with shards." << endl;
+			return 0;
+		}
+		//the distance to the nearest roadrunner would have to be shared across strips
+		if(config.pursuitDistance > 0) {
+			cout << "Pursuit cannot be combined with shards." << endl;
+			return 0;
+		}
+		//a cluster can span several strips
+		if(config.trackClusters) {
+			cout << "Cluster statistics cannot be combined with shards." << endl;
+			return 0;
+		}
+		//the state hash covers the board and agents of a single simulation
+		if(config.hashTrace || config.stopOnRepeat) {
+			cout << "--hash-trace and --stop-on-repeat cannot be combined with shards." << endl;
+			return 0;
+		}
+		//the sharded run is driven from the menu of rank 0, and checkpoints hold the agents of a single simulation
+		if(controlFromStdin || !controlSocketPath.empty()) {
+			cout << "--control and --control-socket cannot be combined with shards." << endl;
+			return 0;
+		}
+		if(checkpointFileName != NULL) {
+			cout << "--restore cannot be combined with shards." << endl;
+			return 0;
+		}
+		//the telemetry segment is published by the simulation of a whole board
+		if(!config.telemetryFileName.empty()) {
+			cout << "Telemetry cannot be published with shards." << endl;
+			return 0;
+		}
+		if(config.numOfShards > config.numOfRows / (2 * ShardedSimulation::haloRows)) {
+			cout << "Too many shards for the number of rows in the board." << endl;
+			return 0;
+		}
+		//every strip counts its part of the same window of the board
+		BoardRenderer shardRenderer(config.numOfViewRows, config.numOfViewColumns, config.zoom);
+		SocketCommunicator* communicator = NULL;
+		ShardedSimulation* shardedSimulation = NULL;
+		//a shard that loses its connection to another throws. Every shard then stops: closing its sockets makes the others throw as well
+		try {
+			communicator = SocketCommunicator::spawn(config.numOfShards);
+			shardedSimulation = new ShardedSimulation(communicator, config.numOfRows, config.numOfColumns, config.initialNumOfRoadrunners, config.initialNumOfCoyotes, seed, &shardRenderer);
+			shardedSimulation->run(menuLogic, printOptions, readStopCondition);
+		} catch(exception &e) {
+			cout << e.what() << endl;
+		}
+		delete shardedSimulation;
+		delete communicator;
+		return 0;
 	}
 
-	//add coyotes to the agenList vector in random unoccupied locations
-	for (int i = 0; i < initialNumOfCoyotes; i++) {
-		do {
-			tempLocation.setCoordinates(rand() % numOfRows, rand() % numOfColumns);
-		} while (!myBoard->existsHere(BoardOccupantTypes::unoccupied, tempLocation));
-		agentList.push_back(new Coyote(myBoard, tempLocation));
+	if(!ensembleMetric.empty()) {
+		//the replicas run unattended from a fresh start each
+		if(controlFromStdin || !controlSocketPath.empty()) {
+			cout << "--control and --control-socket cannot be combined with an ensemble." << endl;
+			return 0;
+		}
+		if(checkpointFileName != NULL) {
+			cout << "--restore cannot be combined with an ensemble." << endl;
+			return 0;
+		}
+		EnsembleMetricTypes metric;
+		if(ensembleMetric == "extinction") {
+			metric = EnsembleMetricTypes::coyoteExtinction;
+		} else if(ensembleMetric == "saturation") {
+			metric = EnsembleMetricTypes::saturationTime;
+		} else {
+			cout << "Unknown ensemble metric " << ensembleMetric << ". Use extinction or saturation. Aborting." << endl;
+			return 0;
+		}
+		//the default precision is 2 percentage points for a probability and 5 time steps for a mean
+		if(ensemblePrecision <= 0) {
+			ensemblePrecision = metric == EnsembleMetricTypes::coyoteExtinction ? 0.02 : 5;
+		}
+		if(ensembleHorizon == 0 || maxReplicas == 0) {
+			cout << "The horizon and the number of replicas must be positive. Aborting." << endl;
+			return 0;
+		}
+		try {
+			EnsembleRunner ensemble(config, metric, ensembleHorizon, ensemblePrecision, maxReplicas, numOfJobs, seed);
+			ensemble.run();
+		} catch(exception &e) {
+			cout << e.what() << endl;
+		}
+		return 0;
 	}
 
+	Simulation* simulationInstance;
+	try {
+		simulationInstance = new Simulation(config, seed);
+	} catch(exception &e) {
+		cout << e.what() << endl;
+		return 0;
+	}
+	Simulation &simulation = *simulationInstance;
+	if(checkpointFileName != NULL) {
+		try {
+			simulation.loadCheckpoint(checkpointFileName);
+		} catch(exception &e) {
+			cout << e.what() << endl;
+			delete simulationInstance;
+			return 0;
+		}
+	}
+
+	//the board is printed through a window if the config sets one up, or if it can be set up through the control channel
+	BoardRenderer* renderer = NULL;
+	if(config.zoom > 1 || config.numOfViewRows != 0 || config.numOfViewColumns != 0 || controlFromStdin || !controlSocketPath.empty()) {
+		renderer = new BoardRenderer(config.numOfViewRows, config.numOfViewColumns, config.zoom);
+	}
+
+	//with a control channel, the simulation runs without the menu and is steered by commands instead
+	if(controlFromStdin || !controlSocketPath.empty()) {
+		try {
+			ControlChannel channel(controlFromStdin, controlSocketPath);
+			runControlled(simulation, channel, *renderer, config.hashTrace);
+		} catch(exception &e) {
+			cout << e.what() << endl;
+		}
+		showBoard(simulation.getBoard(), renderer);
+		delete renderer;
+		delete simulationInstance;
+		cout << endl << "End of simulation." << endl << endl;
+		return 0;
+	}
+	SimulationBoard* myBoard = simulation.getBoard();
+
 	cout << "Initial state of board: " << endl;
-	myBoard->printBoard();
-	Agent* temp = NULL;
+	showBoard(myBoard, renderer);
 	char prompt;
 	int timeStepsCountdown = 0;
+	StopCondition* stopCondition = NULL;
 
-	printOptions();
-	cin >> prompt;
-	timeStepsCountdown = menuLogic(prompt);
+	//prints the menu and reads the user's choice. If the user chooses to run until a condition is met, the condition is read as well
+	std::function<void()> readChoice = [&]() {
+		printOptions();
+		if(renderer != NULL) {
+			printViewOptions();
+		}
+		cin >> prompt;
+		//moving the window shows the board again without running a time step
+		while(renderer != NULL && viewLogic(prompt, *renderer)) {
+			showBoard(myBoard, renderer);
+			printOptions();
+			printViewOptions();
+			cin >> prompt;
+		}
+		timeStepsCountdown = menuLogic(prompt);
+		delete stopCondition;
+		stopCondition = NULL;
+		if(prompt == '8') {
+			stopCondition = readStopCondition(myBoard->numOfCoyotes(), myBoard->numOfRoadRunners());
+			if(stopCondition == NULL) {
+				timeStepsCountdown = -2;
+			}
+		}
+	};
+
+	//depending on whether the user has chosen to skip or not skip viewing this step in the simulation, the board is printed
+	//and the menu options are printed
+	std::function<void()> showBoardIfDue = [&]() {
+		if(timeStepsCountdown == 0 || timeStepsCountdown == -1) {
+			showBoard(myBoard, renderer);
+			readChoice();
+		}
+	};
+
+	readChoice();
 
 	//Run until no agents left or until only roadrunners left
-	while (agentList.size() != 0 && myBoard->numOfRoadRunners() < numOfRows * numOfColumns) {
+	while (!simulation.finished()) {
 
 		//used to keep track of the number of time steps to be jumped (as chosen by the user)
 		timeStepsCountdown--;
-		//shuffle agents each time step
-		shuffleAgents(agentList, 0);
-		for (int i = 0; i < agentList.size(); i++) {
-			//each agent's act() function is called
-			temp = (agentList[i])->act();
-			//if the agent returns a baby agent, the baby is added to agentList
-			if (temp != NULL) {
-				agentList.push_back(temp);
-				shuffleAgents(agentList, i + 1);
-			}
-			//depending on whether the user has chosen to skip or not skip viewing this step in the simulation, the board is printed
-			//and the menu options are printed
-			if(timeStepsCountdown == 0 || timeStepsCountdown == -1) {
-				myBoard->printBoard();
-				printOptions();
-				cin >> prompt;
-				timeStepsCountdown = menuLogic(prompt);
+		try {
+			if(stopCondition != NULL) {
+				//fast-forward without looking at the board after each act(). The condition is checked once per time step against the
+				//population counts kept by the board
+				simulation.step(std::function<void()>());
+				//the walls of the terrain can never be occupied, so a full board is measured against the cells a coyote can stand on
+				if(stopCondition->isMet(myBoard->numOfCoyotes(), myBoard->numOfRoadRunners(), myBoard->numOfHabitableCells(BoardOccupantTypes::coyote))) {
+					cout << "Stopped at time step " << simulation.getStats().stepNumber << " because " << stopCondition->describe() << "." << endl;
+					showBoard(myBoard, renderer);
+					readChoice();
+				}
+			} else {
+				simulation.step(showBoardIfDue);
 			}
+		} catch(runtime_error &e) {
+			//a frame could not be written
+			cout << e.what() << endl;
+			break;
+		}
+		//the trace goes to the error stream so that it can be captured apart from the board and menu, and compared between runs
+		if(config.hashTrace) {
+			fprintf(stderr, "%lu %016llx\n", simulation.getStats().stepNumber, simulation.getStateHash());
+		}
+		if(simulation.getRepeatedStep() != -1) {
+			cout << "Stopped at time step " << simulation.getStats().stepNumber << " because the state repeats time step " << simulation.getRepeatedStep() << "." << endl;
 		}
 		//if the user chose to end the simulation, we break out of the loop
 		if(timeStepsCountdown < -1) {
 			break;
 		}
-		//clear list of dead agents
-		cleanAgentList(agentList);
 	}
-	myBoard->printBoard();
+	delete stopCondition;
+	showBoard(myBoard, renderer);
+	delete renderer;
+	delete simulationInstance;
 	cout << endl << "End of simulation." << endl << endl;
-	//deallocate pointers
-	for(int i = 0; i < agentList.size(); i++) {
-		delete agentList[i];
-	}
 	return 0;
 }